@@ -50,7 +50,11 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  if (m_sumValues != 0)
+    {
+      // reuse the storage of the previous reception
+      (*m_sumValues) = 0;
+    }
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +63,11 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if (m_sumValues == 0 || m_sumValues->GetSpectrumModelUid () != sinr.GetSpectrumModelUid ())
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
+  m_sumValues->AddScaled (sinr, duration.GetSeconds ());
   m_totDuration += duration;
 }
 
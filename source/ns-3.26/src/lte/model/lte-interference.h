@@ -141,6 +141,13 @@ private:
   uint32_t m_lastSignalId;
   uint32_t m_lastSignalIdBeforeReset;
 
+  SpectrumValue m_interf; /**< interference plus noise of the last
+                           * chunk, kept so that its storage is reused
+                           */
+  SpectrumValue m_sinr;   /**< SINR of the last chunk, kept so that its
+                           * storage is reused
+                           */
+
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
   std::list<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
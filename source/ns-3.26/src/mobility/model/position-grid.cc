@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/mobility-model.h"
+#include "position-grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PositionGrid");
+
+bool
+PositionGrid::Cell::operator < (const Cell &o) const
+{
+  if (x != o.x)
+    {
+      return x < o.x;
+    }
+  if (y != o.y)
+    {
+      return y < o.y;
+    }
+  return z < o.z;
+}
+
+PositionGrid::PositionGrid ()
+  : m_cellSize (100.0)
+{
+}
+
+PositionGrid::~PositionGrid ()
+{
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator it = m_entriesOf.begin ();
+       it != m_entriesOf.end (); it++)
+    {
+      m_mobility[it->second.front ()]->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PositionGrid::CourseChanged, this));
+    }
+}
+
+void
+PositionGrid::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0);
+  m_cellSize = cellSize;
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator it = m_entriesOf.begin ();
+       it != m_entriesOf.end (); it++)
+    {
+      m_mobility[it->second.front ()]->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PositionGrid::CourseChanged, this));
+    }
+  m_mobility.clear ();
+  m_cellOf.clear ();
+  m_cells.clear ();
+  m_entriesOf.clear ();
+  m_moving.clear ();
+}
+
+void
+PositionGrid::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT (mobility != 0);
+  uint32_t i = m_mobility.size ();
+  m_mobility.push_back (mobility);
+  m_cellOf.push_back (GetCell (mobility->GetPosition ()));
+  m_cells[m_cellOf[i]].push_back (i);
+  std::vector<uint32_t> &entries = m_entriesOf[PeekPointer (mobility)];
+  if (entries.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&PositionGrid::CourseChanged, this));
+      UpdateMoving (mobility);
+    }
+  entries.push_back (i);
+}
+
+uint32_t
+PositionGrid::GetN (void) const
+{
+  return m_mobility.size ();
+}
+
+PositionGrid::Cell
+PositionGrid::GetCell (Vector position) const
+{
+  Cell cell;
+  cell.x = static_cast<int64_t> (std::floor (position.x / m_cellSize));
+  cell.y = static_cast<int64_t> (std::floor (position.y / m_cellSize));
+  cell.z = static_cast<int64_t> (std::floor (position.z / m_cellSize));
+  return cell;
+}
+
+void
+PositionGrid::Place (uint32_t i)
+{
+  Cell cell = GetCell (m_mobility[i]->GetPosition ());
+  if (!(cell < m_cellOf[i]) && !(m_cellOf[i] < cell))
+    {
+      return;
+    }
+  std::vector<uint32_t> &old = m_cells[m_cellOf[i]];
+  old.erase (std::find (old.begin (), old.end (), i));
+  if (old.empty ())
+    {
+      m_cells.erase (m_cellOf[i]);
+    }
+  m_cellOf[i] = cell;
+  m_cells[cell].push_back (i);
+}
+
+void
+PositionGrid::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator it = m_entriesOf.find (PeekPointer (mobility));
+  if (it == m_entriesOf.end ())
+    {
+      return;
+    }
+  for (std::vector<uint32_t>::const_iterator i = it->second.begin (); i != it->second.end (); i++)
+    {
+      Place (*i);
+    }
+  UpdateMoving (mobility);
+}
+
+void
+PositionGrid::UpdateMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+    {
+      m_moving.insert (PeekPointer (mobility));
+    }
+  else
+    {
+      m_moving.erase (PeekPointer (mobility));
+    }
+}
+
+void
+PositionGrid::GetInRange (Vector position, double range, std::vector<uint32_t> &entries)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  NS_ASSERT (range >= 0);
+  for (std::set<const MobilityModel *>::const_iterator m = m_moving.begin (); m != m_moving.end (); m++)
+    {
+      const std::vector<uint32_t> &moved = m_entriesOf[*m];
+      for (std::vector<uint32_t>::const_iterator i = moved.begin (); i != moved.end (); i++)
+        {
+          Place (*i);
+        }
+    }
+  Cell center = GetCell (position);
+  //A range larger than the cell size, e.g. after the range attribute of
+  //the owner was raised, extends the search to more layers of cells
+  int64_t span = std::max (static_cast<int64_t> (std::ceil (range / m_cellSize)), static_cast<int64_t> (1));
+  entries.clear ();
+  for (int64_t dx = -span; dx <= span; dx++)
+    {
+      for (int64_t dy = -span; dy <= span; dy++)
+        {
+          for (int64_t dz = -span; dz <= span; dz++)
+            {
+              Cell cell = {center.x + dx, center.y + dy, center.z + dz};
+              std::map<Cell, std::vector<uint32_t> >::const_iterator it = m_cells.find (cell);
+              if (it == m_cells.end ())
+                {
+                  continue;
+                }
+              for (std::vector<uint32_t>::const_iterator i = it->second.begin (); i != it->second.end (); i++)
+                {
+                  if (CalculateDistance (position, m_mobility[*i]->GetPosition ()) <= range)
+                    {
+                      entries.push_back (*i);
+                    }
+                }
+            }
+        }
+    }
+  //Callers rely on the order in which the entries were added
+  std::sort (entries.begin (), entries.end ());
+}
+
+} //namespace ns3
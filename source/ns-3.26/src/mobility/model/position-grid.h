@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POSITION_GRID_H
+#define POSITION_GRID_H
+
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief uniform grid of the positions of a list of mobility models
+ * \ingroup mobility
+ *
+ * Entries are identified by their index in the order they were added,
+ * which is typically the order of the PHY list of a channel. The grid
+ * follows the CourseChange trace of the mobility model of each entry, so
+ * that the entries within a given range of a position (e.g., of a
+ * transmitter) are found by only visiting the neighbouring cells.
+ * Several entries may share a mobility model.
+ *
+ * Models such as ConstantVelocity or RandomWalk2d move between course
+ * changes. An entry whose velocity is not zero at its last course change
+ * is therefore moved to the cell of its current position at every
+ * lookup, so the grid is exact for all models that report their
+ * velocity; the lookup cost grows with the number of moving entries.
+ */
+class PositionGrid
+{
+public:
+  PositionGrid ();
+  ~PositionGrid ();
+
+  /**
+   * Set the edge length of the cells. This removes all entries.
+   *
+   * \param cellSize the edge length of the cells in meters
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * Add the next entry.
+   *
+   * \param mobility the mobility model of the entry
+   */
+  void Add (Ptr<MobilityModel> mobility);
+  /**
+   * \return the number of entries in the grid
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param position the center of the search
+   * \param range the maximum distance. Ranges larger than the cell size
+   *        are supported, but visit more cells.
+   * \param entries the indexes of the entries within range, in
+   *        ascending order
+   */
+  void GetInRange (Vector position, double range, std::vector<uint32_t> &entries);
+  /**
+   * Index the PHYs of a channel that were attached since the previous
+   * call, then get the ones within range of a transmitter. The cell size
+   * is set to the range (at least 1 m) when the first PHY is indexed.
+   *
+   * \param phys the PHY list of a channel, which only grows; each PHY
+   *        must have a mobility model
+   * \param position the position of the transmitter
+   * \param range the maximum distance
+   * \param entries the indexes in the PHY list of the PHYs within range,
+   *        in ascending order
+   */
+  template <typename T>
+  void GetPhysInRange (const std::vector<Ptr<T> > &phys, Vector position, double range,
+                       std::vector<uint32_t> &entries);
+
+private:
+  /// Coordinates of a cell
+  struct Cell
+  {
+    int64_t x; //!< x index
+    int64_t y; //!< y index
+    int64_t z; //!< z index
+
+    bool operator < (const Cell &o) const;
+  };
+
+  /**
+   * \param position a position
+   * \return the cell containing the position
+   */
+  Cell GetCell (Vector position) const;
+  /**
+   * Move an entry to the cell of its current position.
+   *
+   * \param i the index of the entry
+   */
+  void Place (uint32_t i);
+  /**
+   * \param mobility the mobility model that reported a course change
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  /**
+   * Track whether a mobility model moves between course changes.
+   *
+   * \param mobility the mobility model of one or more entries
+   */
+  void UpdateMoving (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                                   //!< edge length of the cells
+  std::vector<Ptr<MobilityModel> > m_mobility;         //!< mobility model per entry
+  std::vector<Cell> m_cellOf;                          //!< current cell per entry
+  std::map<Cell, std::vector<uint32_t> > m_cells;      //!< entries per non-empty cell
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_entriesOf; //!< entries per mobility model
+  std::set<const MobilityModel *> m_moving;            //!< mobility models with a non-zero velocity
+};
+
+template <typename T>
+void
+PositionGrid::GetPhysInRange (const std::vector<Ptr<T> > &phys, Vector position, double range,
+                              std::vector<uint32_t> &entries)
+{
+  if (GetN () == 0 && !phys.empty ())
+    {
+      SetCellSize (std::max (range, 1.0));
+    }
+  //PHYs are indexed once their mobility model is known, i.e. at their first frame
+  for (uint32_t j = GetN (); j < phys.size (); j++)
+    {
+      Add (phys[j]->GetMobility ()->template GetObject<MobilityModel> ());
+    }
+  GetInRange (position, range, entries);
+}
+
+} //namespace ns3
+
+#endif /* POSITION_GRID_H */
@@ -31,6 +31,9 @@
 #include "ns3/mobility-model.h"
 #include "ns3/waypoint-mobility-model.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/position-grid.h"
 
 using namespace ns3;
 
@@ -354,6 +357,106 @@ WaypointMobilityModelViaHelper::DoRun (void)
   Simulator::Destroy ();
 }
 
+// Test that PositionGrid finds the entries within a range larger than
+// its cell size, and follows the course changes of the entries
+class PositionGridRange : public TestCase
+{
+public:
+  PositionGridRange ();
+  virtual ~PositionGridRange ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PositionGridRange::PositionGridRange ()
+  : TestCase ("Test PositionGrid with ranges above the cell size")
+{
+}
+
+PositionGridRange::~PositionGridRange ()
+{
+}
+
+void
+PositionGridRange::DoRun (void)
+{
+  PositionGrid grid;
+  grid.SetCellSize (10.0);
+  double xs[] = {0.0, 5.0, 15.0, 35.0, 100.0};
+  std::vector<Ptr<ConstantPositionMobilityModel> > mobility;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+      mobility[i]->SetPosition (Vector (xs[i], 0.0, 0.0));
+      grid.Add (mobility[i]);
+    }
+  std::vector<uint32_t> entries;
+  grid.GetInRange (Vector (0.0, 0.0, 0.0), 8.0, entries);
+  NS_TEST_ASSERT_MSG_EQ (entries.size (), 2, "Two entries within the cell size");
+  grid.GetInRange (Vector (0.0, 0.0, 0.0), 40.0, entries);
+  NS_TEST_ASSERT_MSG_EQ (entries.size (), 4, "Four entries within four cells");
+  NS_TEST_EXPECT_MSG_EQ (entries[3], 3, "Entries are in the order they were added");
+  mobility[4]->SetPosition (Vector (0.0, 30.0, 0.0));
+  grid.GetInRange (Vector (0.0, 0.0, 0.0), 40.0, entries);
+  NS_TEST_ASSERT_MSG_EQ (entries.size (), 5, "The moved entry is found");
+  NS_TEST_EXPECT_MSG_EQ (entries[4], 4, "Entries are in the order they were added");
+}
+
+// Test that PositionGrid follows the entries that move between course
+// changes, and stops following them once they stop
+class PositionGridMoving : public TestCase
+{
+public:
+  PositionGridMoving ();
+  virtual ~PositionGridMoving ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param grid the grid
+   * \param expected the expected number of entries within 5 m of the origin
+   */
+  void CheckInRange (PositionGrid *grid, uint32_t expected);
+};
+
+PositionGridMoving::PositionGridMoving ()
+  : TestCase ("Test PositionGrid with entries moving at a constant velocity")
+{
+}
+
+PositionGridMoving::~PositionGridMoving ()
+{
+}
+
+void
+PositionGridMoving::CheckInRange (PositionGrid *grid, uint32_t expected)
+{
+  std::vector<uint32_t> entries;
+  grid->GetInRange (Vector (0.0, 0.0, 0.0), 5.0, entries);
+  NS_TEST_EXPECT_MSG_EQ (entries.size (), expected, "Entries within range at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+PositionGridMoving::DoRun (void)
+{
+  PositionGrid grid;
+  grid.SetCellSize (10.0);
+  Ptr<ConstantPositionMobilityModel> fixed = CreateObject<ConstantPositionMobilityModel> ();
+  grid.Add (fixed);
+  //Starts 100 m away and reaches the origin at 10 s, without any course change
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (-100.0, 0.0, 0.0));
+  moving->SetVelocity (Vector (10.0, 0.0, 0.0));
+  grid.Add (moving);
+  Simulator::Schedule (Seconds (1.0), &PositionGridMoving::CheckInRange, this, &grid, 1);
+  Simulator::Schedule (Seconds (10.0), &PositionGridMoving::CheckInRange, this, &grid, 2);
+  Simulator::Schedule (Seconds (10.0), &ConstantVelocityMobilityModel::SetVelocity, moving, Vector (0.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (20.0), &PositionGridMoving::CheckInRange, this, &grid, 2);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 class MobilityTestSuite : public TestSuite
 {
 public:
@@ -367,6 +470,8 @@ MobilityTestSuite::MobilityTestSuite ()
   AddTestCase (new WaypointLazyNotifyTrue, TestCase::QUICK);
   AddTestCase (new WaypointInitialPositionIsWaypoint, TestCase::QUICK);
   AddTestCase (new WaypointMobilityModelViaHelper, TestCase::QUICK);
+  AddTestCase (new PositionGridRange, TestCase::QUICK);
+  AddTestCase (new PositionGridMoving, TestCase::QUICK);
 }
 
 static MobilityTestSuite mobilityTestSuite;
@@ -169,13 +169,13 @@ double
 Enterprise11axPropagationLossModel::CalculateFcFromBitMap(void)
 {
   double fc = 0.0;
-  HEBitMap BitMap;
-  double offset = 0.0;
-  fc = BitMap.GetCentralFrequencyFromChannelNumber(m_channelNumber);
-  RUInfo RU = {0};
-  RU = BitMap.GetRUInfoFromTriggerBitMap(m_bitMap);
-  offset = BitMap.GetRUOffset(RU.type, RU.index, m_channelNumber);
-  fc = fc + offset;
+  if (m_bitMap < 0 || m_bitMap > 255)
+    {
+      fc = HEBitMap::GetCentralFrequencyFromChannelNumber(m_channelNumber);
+      RUInfo RU = HEBitMap::GetRUInfoFromTriggerBitMap(m_bitMap);
+      return fc + HEBitMap::GetRUOffset(RU.type, RU.index, m_channelNumber);
+    }
+  fc = HERuTable::Get ().GetCentralFrequency (m_bitMap, m_channelNumber);
   return fc;
 }
 
@@ -63,7 +63,6 @@ private:
                                 int BitMap, int ChannelNumber);
   virtual int64_t DoAssignStreams (int64_t stream);
 
-  HEBitMap BitMap;
   double m_frequency;
   double m_baseFreq;
   double m_indoorWallLoss;
@@ -73,7 +73,6 @@ HEBitMap::GetTypeId (void)
 HEBitMap::HEBitMap ()
 {
   NS_LOG_FUNCTION (this);
-  HEMuPPDUConstuctTable(&m_RUDistTable);
 }
 
 HEBitMap::~HEBitMap ()
@@ -478,7 +477,7 @@ void HEBitMap::GetRUDistFromBitMap(unsigned char *RUrow, int BitMap)
   unsigned char i;
   for (i=0; i<9; i++)
   {
-    RUrow[i] = m_RUDistTable.table[index][i];
+    RUrow[i] = HERuTable::Get ().GetRUDistTable ().table[index][i];
   }
 }
 
@@ -902,11 +901,11 @@ double HEBitMap::GetRUOffset(int RUtype, int RUindex, int channelNumber)
   if (channelNumber%4 == 0 || (channelNumber >= 1 && channelNumber <= 11))
   {
     // 20Mhz case
-    if (RUtype == 1)
+    if (RUtype == 1 && RUindex < 9)
       offset = RUoff26[RUindex]*subcarrierSpacing;
-    else if (RUtype == 2)
+    else if (RUtype == 2 && RUindex < 4)
       offset = RUoff52[RUindex]*subcarrierSpacing;
-    else if (RUtype == 3)
+    else if (RUtype == 3 && RUindex < 2)
       offset = RUoff106[RUindex]*subcarrierSpacing;
     else if (RUtype == 4)
       offset = 0;
@@ -1432,4 +1431,80 @@ RUData::GetNumberOfMimoUsers(void )
 }
 
 
+const HERuTable &
+HERuTable::Get (void)
+{
+  static const HERuTable table;
+  return table;
+}
+
+HERuTable::HERuTable ()
+{
+  HEBitMap::HEMuPPDUConstuctTable (&m_ruDist);
+  for (int channelNumber = 0; channelNumber < 256; channelNumber++)
+    {
+      m_channelFrequency[channelNumber] = HEBitMap::GetCentralFrequencyFromChannelNumber (channelNumber);
+      // Same classification as HEBitMap::GetRUOffset
+      if (channelNumber%4 == 0 || (channelNumber >= 1 && channelNumber <= 11))
+        m_channelClass[channelNumber] = CHANNEL_20MHZ;
+      else if (channelNumber == 50 || channelNumber == 114)
+        m_channelClass[channelNumber] = CHANNEL_160MHZ;
+      else if (channelNumber == 42 || channelNumber == 58 || channelNumber == 106 || channelNumber == 122)
+        m_channelClass[channelNumber] = CHANNEL_80MHZ;
+      else
+        m_channelClass[channelNumber] = CHANNEL_40MHZ;
+    }
+  // A representative channel number of each class
+  static const int classChannel[CHANNEL_CLASSES] = {36, 38, 42, 50};
+  for (int bitMap = 0; bitMap < 256; bitMap++)
+    {
+      m_ruInfo[bitMap] = HEBitMap::GetRUInfoFromTriggerBitMap (bitMap);
+      for (int c = 0; c < CHANNEL_CLASSES; c++)
+        {
+          m_offset[c][bitMap] = HEBitMap::GetRUOffset (m_ruInfo[bitMap].type, m_ruInfo[bitMap].index, classChannel[c]);
+        }
+    }
+}
+
+const MuPPDUBitMapTable &
+HERuTable::GetRUDistTable (void) const
+{
+  return m_ruDist;
+}
+
+uint8_t
+HERuTable::GetChannelIndex (int channelNumber) const
+{
+  // Unknown channel numbers behave as HEBitMap::GetCentralFrequencyFromChannelNumber
+  return (channelNumber >= 0 && channelNumber < 256) ? channelNumber : 0;
+}
+
+RUInfo
+HERuTable::GetRUInfo (uint8_t bitMap) const
+{
+  return m_ruInfo[bitMap];
+}
+
+double
+HERuTable::GetRUOffset (uint8_t bitMap, int channelNumber) const
+{
+  if (channelNumber < 0 || channelNumber > 255)
+    {
+      return HEBitMap::GetRUOffset (m_ruInfo[bitMap].type, m_ruInfo[bitMap].index, channelNumber);
+    }
+  return m_offset[m_channelClass[channelNumber]][bitMap];
+}
+
+double
+HERuTable::GetChannelFrequency (int channelNumber) const
+{
+  return m_channelFrequency[GetChannelIndex (channelNumber)];
+}
+
+double
+HERuTable::GetCentralFrequency (uint8_t bitMap, int channelNumber) const
+{
+  return GetChannelFrequency (channelNumber) + GetRUOffset (bitMap, channelNumber);
+}
+
 }
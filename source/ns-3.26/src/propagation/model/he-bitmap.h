@@ -66,6 +66,76 @@ private:
   uint8_t m_mimoUsers;
 };
 
+/**
+ * \brief immutable RU lookup tables shared by all HEBitMap users
+ *
+ * The MU PPDU RU distribution table and the per-channel RU offsets only
+ * depend on constants of the standard, so they are built once for the
+ * whole simulation instead of once per HEBitMap. The centre frequency and
+ * offset of an RU given its 8-bit trigger bitmap and the channel number
+ * are then obtained in constant time.
+ */
+class HERuTable
+{
+public:
+  /**
+   * \return the table shared by the whole simulation
+   */
+  static const HERuTable & Get (void);
+
+  /**
+   * \return the MU PPDU RU distribution table (39 bitmaps x 9 RUs)
+   */
+  const MuPPDUBitMapTable & GetRUDistTable (void) const;
+  /**
+   * \param bitMap the trigger bitmap of the RU
+   * \return the type and index of the RU
+   */
+  RUInfo GetRUInfo (uint8_t bitMap) const;
+  /**
+   * \param bitMap the trigger bitmap of the RU
+   * \param channelNumber the channel number
+   * \return the offset of the RU centre from the channel centre in Hz
+   */
+  double GetRUOffset (uint8_t bitMap, int channelNumber) const;
+  /**
+   * \param bitMap the trigger bitmap of the RU
+   * \param channelNumber the channel number
+   * \return the centre frequency of the RU in Hz
+   */
+  double GetCentralFrequency (uint8_t bitMap, int channelNumber) const;
+  /**
+   * \param channelNumber the channel number
+   * \return the centre frequency of the channel in Hz
+   */
+  double GetChannelFrequency (int channelNumber) const;
+
+private:
+  HERuTable ();
+
+  /// Channel bandwidth classes used to compute RU offsets
+  enum ChannelClass
+  {
+    CHANNEL_20MHZ = 0,
+    CHANNEL_40MHZ,
+    CHANNEL_80MHZ,
+    CHANNEL_160MHZ,
+    CHANNEL_CLASSES
+  };
+
+  /**
+   * \param channelNumber the channel number
+   * \return the index of the channel in the tables
+   */
+  uint8_t GetChannelIndex (int channelNumber) const;
+
+  MuPPDUBitMapTable m_ruDist;             //!< RU distribution per MU PPDU bitmap
+  RUInfo m_ruInfo[256];                   //!< RU type and index per trigger bitmap
+  double m_offset[CHANNEL_CLASSES][256];  //!< RU offset per channel class and trigger bitmap
+  double m_channelFrequency[256];         //!< centre frequency per channel number
+  uint8_t m_channelClass[256];            //!< channel class per channel number
+};
+
 typedef struct heMcsInfo_ {
   uint32_t mcs;
   uint32_t bufValue;
@@ -85,25 +155,25 @@ public:
 
   ~HEBitMap();
 
-  void HEMuPPDUConstuctTable(struct MuPPDUBitMapTable *Table);
+  static void HEMuPPDUConstuctTable(struct MuPPDUBitMapTable *Table);
 
   unsigned char GetIndexFromBitMap(int BitMapValue);
 
   void GetRUDistFromBitMap(unsigned char *row, int BitMapValue);
 
-  RUInfo GetRUInfoFromTriggerBitMap(int BitMapValue);
+  static RUInfo GetRUInfoFromTriggerBitMap(int BitMapValue);
   
   RUData GetRUDataFromBitMap(uint8_t BitMapValue, int channelNumber);
   
   uint8_t GetBitMapFromRUInfo(struct RUInfo RU);
 
-  double GetRUOffset(int RUtype, int RUindex, int channelNumber);
+  static double GetRUOffset(int RUtype, int RUindex, int channelNumber);
 
   void CalculateFcFromRUDist(double *Fc, unsigned char *RUrow);
 
   double GetCentralFrequencyFromChannelNumber2_4GHz20MHz(int channelNumber);
 
-  double GetCentralFrequencyFromChannelNumber(int channelNumber);
+  static double GetCentralFrequencyFromChannelNumber(int channelNumber);
 
   ruVector GetRuVectorFromRuBitMap(uint8_t BitMap);
 
@@ -119,9 +189,6 @@ public:
   int m_DataBitMap;
   RUInfo m_RU;
   int m_TriggerBitMap;
-
-private:
-  MuPPDUBitMapTable m_RUDistTable;
 };
 
 }
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/object.h"
+#include "ns3/he-bitmap.h"
+
+using namespace ns3;
+
+/**
+ * Check that the lookups of HERuTable give the same results as the
+ * HEBitMap computations they replace, for every trigger bitmap and every
+ * channel number.
+ */
+class HERuTableTestCase : public TestCase
+{
+public:
+  HERuTableTestCase ();
+  virtual ~HERuTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+HERuTableTestCase::HERuTableTestCase ()
+  : TestCase ("Check the precomputed RU table against the HEBitMap computations")
+{
+}
+
+HERuTableTestCase::~HERuTableTestCase ()
+{
+}
+
+void
+HERuTableTestCase::DoRun (void)
+{
+  const HERuTable &table = HERuTable::Get ();
+
+  MuPPDUBitMapTable ruDist;
+  HEBitMap::HEMuPPDUConstuctTable (&ruDist);
+  for (uint32_t i = 0; i < 39; i++)
+    {
+      for (uint32_t j = 0; j < 9; j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((uint32_t)table.GetRUDistTable ().table[i][j], (uint32_t)ruDist.table[i][j],
+                                 "RU distribution of row " << i << ", RU " << j);
+        }
+    }
+
+  for (int bitMap = 0; bitMap < 256; bitMap++)
+    {
+      RUInfo ru = HEBitMap::GetRUInfoFromTriggerBitMap (bitMap);
+      NS_TEST_EXPECT_MSG_EQ (table.GetRUInfo (bitMap).type, ru.type, "RU type of bitmap " << bitMap);
+      NS_TEST_EXPECT_MSG_EQ (table.GetRUInfo (bitMap).index, ru.index, "RU index of bitmap " << bitMap);
+      //Channel numbers out of the table are computed on the fly
+      for (int channelNumber = -1; channelNumber <= 256; channelNumber++)
+        {
+          double fc = HEBitMap::GetCentralFrequencyFromChannelNumber (channelNumber)
+            + HEBitMap::GetRUOffset (ru.type, ru.index, channelNumber);
+          NS_TEST_EXPECT_MSG_EQ (table.GetCentralFrequency (bitMap, channelNumber), fc,
+                                 "Centre frequency of bitmap " << bitMap << " on channel " << channelNumber);
+        }
+    }
+}
+
+class HEBitMapTestSuite : public TestSuite
+{
+public:
+  HEBitMapTestSuite ();
+};
+
+HEBitMapTestSuite::HEBitMapTestSuite ()
+  : TestSuite ("he-bitmap", UNIT)
+{
+  AddTestCase (new HERuTableTestCase, TestCase::QUICK);
+}
+
+static HEBitMapTestSuite g_heBitMapTestSuite;
@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -36,6 +37,8 @@
 #include <ns3/angles.h>
 #include <iostream>
 #include <utility>
+#include <algorithm>
+#include <iterator>
 #include "multi-model-spectrum-channel.h"
 
 
@@ -82,6 +85,7 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_receiverGridValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +99,9 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_receiverGrid.SetCellSize (1.0);
+  m_gridPhys.clear ();
+  m_receiverGridValid = false;
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +126,20 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("ReceiverCulling",
+                   "If true, a signal is only passed to the PHYs within CullingRange "
+                   "of the transmitter, which are found through a grid of the positions "
+                   "of the PHYs instead of evaluating the propagation loss towards "
+                   "every PHY. PHYs without a MobilityModel are always considered. "
+                   "Use MaxLossDb to also drop the signals received below a given power.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_receiverCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingRange",
+                   "The maximum distance (m) of a receiver when ReceiverCulling is enabled.",
+                   DoubleValue (1000.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_cullingRange),
+                   MakeDoubleChecker<double> (0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -153,6 +174,9 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 
   std::vector<Ptr<SpectrumPhy> >::const_iterator it;
 
+  // the order of the PHYs changes, the grid is rebuilt at the next transmission
+  m_receiverGridValid = false;
+
   // remove a previous entry of this phy if it exists
   // we need to scan for all rxSpectrumModel values since we don't
   // know which spectrum model the phy had when it was previously added
@@ -272,6 +296,20 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // the receivers share one copy of the transmitted PSD, so that a
+  // receiver only copies the signal parameters and not the PSD
+  Ptr<SpectrumSignalParameters> sharedTxParams = txParams->Copy ();
+  Ptr<const SpectrumValue> txPowerSpectrum = sharedTxParams->psd;
+  sharedTxParams->psd = Create<SpectrumValue> (txPowerSpectrum, 1.0);
+
+  bool culling = m_receiverCulling && txMobility;
+  if (culling)
+    {
+      GetReceivers (txMobility);
+    }
+  uint32_t rxPhyOffset = 0;
+  uint32_t nextReceiver = 0;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -279,101 +317,187 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
-      Ptr <SpectrumValue> convertedTxPowerSpectrum;
+      const std::set<Ptr<SpectrumPhy> > &rxPhySet = rxInfoIterator->second.m_rxPhySet;
+      // the receivers of this model are m_receivers[firstReceiver, nextReceiver)
+      uint32_t firstReceiver = nextReceiver;
+      if (culling)
+        {
+          rxPhyOffset += rxPhySet.size ();
+          while (nextReceiver < m_receivers.size () && m_receivers[nextReceiver] < rxPhyOffset)
+            {
+              nextReceiver++;
+            }
+        }
+      uint32_t nRxPhys = culling ? nextReceiver - firstReceiver : rxPhySet.size ();
+      Ptr<SpectrumPhy> onlyRxPhy = (nRxPhys == 1) ? (culling ? m_gridPhys[m_receivers[firstReceiver]] : *rxPhySet.begin ()) : 0;
+      if (nRxPhys == 0 || onlyRxPhy == txParams->txPhy)
+        {
+          // no receiver for this model, do not convert the PSD
+          continue;
+        }
+
+      Ptr <const SpectrumValue> convertedTxPowerSpectrum;
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
           NS_LOG_LOGIC ("no spectrum conversion needed");
-          convertedTxPowerSpectrum = txParams->psd;
+          convertedTxPowerSpectrum = txPowerSpectrum;
         }
       else
         {
           NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
           SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
           NS_ASSERT (rxConverterIterator != txInfoIteratorerator->second.m_spectrumConverterMap.end ());
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txPowerSpectrum);
         }
 
-
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+      if (culling)
+        {
+          for (uint32_t i = firstReceiver; i < nextReceiver; i++)
+            {
+              StartTxToPhy (sharedTxParams, txMobility, convertedTxPowerSpectrum, m_gridPhys[m_receivers[i]]);
+            }
+          continue;
+        }
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxPhySet.begin ();
+           rxPhyIterator != rxPhySet.end ();
            ++rxPhyIterator)
         {
-          NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
-                         "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+          StartTxToPhy (sharedTxParams, txMobility, convertedTxPowerSpectrum, *rxPhyIterator);
+        }
+    }
 
-          if ((*rxPhyIterator) != txParams->txPhy)
-            {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+}
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+void
+MultiModelSpectrumChannel::StartTxToPhy (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility, Ptr<const SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy)
+{
+  NS_ASSERT_MSG (rxPhy->GetRxSpectrumModel ()->GetUid () == convertedTxPowerSpectrum->GetSpectrumModelUid (),
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
+
+  Time delay = MicroSeconds (0);
+  double pathGainLinear = 1;
+
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+
+  if (txMobility && receiverMobility)
+    {
+      // check the range before the signal parameters are copied,
+      // so that receivers beyond range cost no allocation
+      double pathLossDb = 0;
+      if (txParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+          double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+    }
+
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  // the flat path gain is only applied to the shared PSD when the
+  // receiver reads it
+  rxParams->psd = Create<SpectrumValue> (convertedTxPowerSpectrum, pathGainLinear);
+
+  if (txMobility && receiverMobility)
+    {
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
+    }
+
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, rxPhy);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
+}
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
+void
+MultiModelSpectrumChannel::GetReceivers (Ptr<MobilityModel> txMobility)
+{
+  if (!m_receiverGridValid)
+    {
+      // index the PHYs in the order in which StartTx visits them
+      m_receiverGrid.SetCellSize (std::max (m_cullingRange, 1.0));
+      m_gridPhys.clear ();
+      m_gridEntryPhys.clear ();
+      m_unplacedPhys.clear ();
+      for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+           rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+           ++rxInfoIterator)
+        {
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhySet.begin ();
+               phyIt != rxInfoIterator->second.m_rxPhySet.end ();
+               ++phyIt)
+            {
+              Ptr<MobilityModel> mobility = (*phyIt)->GetMobility ();
+              if (mobility)
                 {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
+                  m_receiverGrid.Add (mobility);
+                  m_gridEntryPhys.push_back (m_gridPhys.size ());
                 }
               else
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  // without a mobility model, the signal is not attenuated
+                  m_unplacedPhys.push_back (m_gridPhys.size ());
                 }
+              m_gridPhys.push_back (*phyIt);
             }
         }
-
+      m_receiverGridValid = true;
     }
-
+  m_receiverGrid.GetInRange (txMobility->GetPosition (), m_cullingRange, m_gridEntries);
+  for (std::vector<uint32_t>::iterator it = m_gridEntries.begin (); it != m_gridEntries.end (); ++it)
+    {
+      *it = m_gridEntryPhys[*it];
+    }
+  m_receivers.clear ();
+  std::merge (m_gridEntries.begin (), m_gridEntries.end (),
+              m_unplacedPhys.begin (), m_unplacedPhys.end (),
+              std::back_inserter (m_receivers));
 }
 
 void
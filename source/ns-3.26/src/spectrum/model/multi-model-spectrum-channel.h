@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/position-grid.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -158,6 +160,27 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Evaluate the propagation towards a receiver and schedule the
+   * reception of the signal if it is within range.
+   *
+   * @param txParams The signal paramters.
+   * @param txMobility The mobility model of the transmitter, if any.
+   * @param convertedTxPowerSpectrum The transmitted PSD in the Rx spectrum model.
+   * @param rxPhy The receiver SpectrumPhy.
+   */
+  void StartTxToPhy (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                     Ptr<const SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy);
+
+  /**
+   * Find the receivers within CullingRange of a transmitter, and store
+   * their indexes in m_gridPhys into m_receivers, in ascending order.
+   * The grid is rebuilt first if a PHY was added since the last call.
+   *
+   * @param txMobility The mobility model of the transmitter.
+   */
+  void GetReceivers (Ptr<MobilityModel> txMobility);
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -201,6 +224,17 @@ private:
    */
   double m_maxLossDb;
 
+  bool m_receiverCulling;  //!< Whether out-of-range receivers are skipped
+  double m_cullingRange;   //!< Maximum distance of a receiver in meters
+
+  PositionGrid m_receiverGrid;                //!< Spatial index of the PHYs with a mobility model
+  bool m_receiverGridValid;                   //!< Whether m_receiverGrid matches m_rxSpectrumModelInfoMap
+  std::vector<Ptr<SpectrumPhy> > m_gridPhys;  //!< All Rx PHYs, in the order in which StartTx visits them
+  std::vector<uint32_t> m_gridEntryPhys;      //!< Index in m_gridPhys of each entry of m_receiverGrid
+  std::vector<uint32_t> m_unplacedPhys;       //!< Indexes in m_gridPhys of the PHYs without a mobility model
+  std::vector<uint32_t> m_gridEntries;        //!< Scratch list of the grid entries in range
+  std::vector<uint32_t> m_receivers;          //!< Indexes in m_gridPhys of the receivers of the current signal
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
@@ -33,6 +33,9 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <ns3/boolean.h>
+#include <algorithm>
+#include <iterator>
 
 
 #include "single-model-spectrum-channel.h"
@@ -45,6 +48,7 @@ NS_LOG_COMPONENT_DEFINE ("SingleModelSpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SingleModelSpectrumChannel);
 
 SingleModelSpectrumChannel::SingleModelSpectrumChannel ()
+  : m_receiverCulling (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -54,6 +58,9 @@ SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_receiverGrid.SetCellSize (1.0);
+  m_gridEntryPhys.clear ();
+  m_unplacedPhys.clear ();
   m_spectrumModel = 0;
   m_propagationDelay = 0;
   m_propagationLoss = 0;
@@ -83,6 +90,20 @@ SingleModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("ReceiverCulling",
+                   "If true, a signal is only passed to the PHYs within CullingRange "
+                   "of the transmitter, which are found through a grid of the positions "
+                   "of the PHYs instead of evaluating the propagation loss towards "
+                   "every PHY. PHYs without a MobilityModel are always considered. "
+                   "Use MaxLossDb to also drop the signals received below a given power.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SingleModelSpectrumChannel::m_receiverCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingRange",
+                   "The maximum distance (m) of a receiver when ReceiverCulling is enabled.",
+                   DoubleValue (1000.0),
+                   MakeDoubleAccessor (&SingleModelSpectrumChannel::m_cullingRange),
+                   MakeDoubleChecker<double> (0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -134,80 +155,132 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  if (m_receiverCulling && senderMobility)
+    {
+      GetReceivers (senderMobility);
+      for (std::vector<uint32_t>::const_iterator it = m_receivers.begin (); it != m_receivers.end (); ++it)
+        {
+          StartTxToPhy (txParams, senderMobility, m_phyList[*it]);
+        }
+      return;
+    }
+
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
     {
-      if ((*rxPhyIterator) != txParams->txPhy)
+      StartTxToPhy (txParams, senderMobility, *rxPhyIterator);
+    }
+
+}
+
+void
+SingleModelSpectrumChannel::StartTxToPhy (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility, Ptr<SpectrumPhy> rxPhy)
+{
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
+
+  Time delay  = MicroSeconds (0);
+
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+  NS_LOG_LOGIC ("copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+  if (senderMobility && receiverMobility)
+    {
+      double pathLossDb = 0;
+      if (rxParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+          double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }                    
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+      *(rxParams->psd) *= pathGainLinear;              
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
         {
-          Time delay  = MicroSeconds (0);
-
-          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-
-          if (senderMobility && receiverMobility)
-            {
-              double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
-                {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                  pathLossDb -= txAntennaGain;
-                }
-              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-              if (rxAntenna != 0)
-                {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                  pathLossDb -= rxAntennaGain;
-                }
-              if (m_propagationLoss)
-                {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
-                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                  pathLossDb -= propagationGainDb;
-                }                    
-              NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-              m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-              if ( pathLossDb > m_maxLossDb)
-                {
-                  // beyond range
-                  continue;
-                }
-              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-              *(rxParams->psd) *= pathGainLinear;              
-
-              if (m_spectrumPropagationLoss)
-                {
-                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
-                }
-
-              if (m_propagationDelay)
-                {
-                  delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
-                }
-            }
-
-
-          Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-          if (netDev)
-            {
-              // the receiver has a NetDevice, so we expect that it is attached to a Node
-              uint32_t dstNode =  netDev->GetNode ()->GetId ();
-              Simulator::ScheduleWithContext (dstNode, delay, &SingleModelSpectrumChannel::StartRx, this, rxParams, *rxPhyIterator);
-            }
-          else
-            {
-              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-              Simulator::Schedule (delay, &SingleModelSpectrumChannel::StartRx, this,
-                                   rxParams, *rxPhyIterator);
-            }
+          delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
         }
     }
 
+
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &SingleModelSpectrumChannel::StartRx, this, rxParams, rxPhy);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &SingleModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
+}
+
+void
+SingleModelSpectrumChannel::GetReceivers (Ptr<MobilityModel> senderMobility)
+{
+  uint32_t nIndexed = m_gridEntryPhys.size () + m_unplacedPhys.size ();
+  if (nIndexed == 0)
+    {
+      m_receiverGrid.SetCellSize (std::max (m_cullingRange, 1.0));
+    }
+  //PHYs are indexed at the first signal following their addition
+  for (uint32_t j = nIndexed; j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ();
+      if (mobility)
+        {
+          m_receiverGrid.Add (mobility);
+          m_gridEntryPhys.push_back (j);
+        }
+      else
+        {
+          //without a mobility model, the signal is not attenuated
+          m_unplacedPhys.push_back (j);
+        }
+    }
+  m_receiverGrid.GetInRange (senderMobility->GetPosition (), m_cullingRange, m_gridEntries);
+  for (std::vector<uint32_t>::iterator it = m_gridEntries.begin (); it != m_gridEntries.end (); ++it)
+    {
+      *it = m_gridEntryPhys[*it];
+    }
+  m_receivers.clear ();
+  std::merge (m_gridEntries.begin (), m_gridEntries.end (),
+              m_unplacedPhys.begin (), m_unplacedPhys.end (),
+              std::back_inserter (m_receivers));
 }
 
 void
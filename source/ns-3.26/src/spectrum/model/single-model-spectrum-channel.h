@@ -25,6 +25,8 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/position-grid.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -81,6 +83,25 @@ private:
    */
   void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Evaluate the propagation towards a receiver and schedule the
+   * reception of the signal if it is within range.
+   *
+   * @param txParams the signal parameters
+   * @param senderMobility the mobility model of the transmitter, if any
+   * @param rxPhy the receiver SpectrumPhy
+   */
+  void StartTxToPhy (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> senderMobility, Ptr<SpectrumPhy> rxPhy);
+
+  /**
+   * Find the PHYs within CullingRange of a transmitter, and store their
+   * indexes in m_phyList into m_receivers, in ascending order. The PHYs
+   * added since the last call are indexed first.
+   *
+   * @param senderMobility the mobility model of the transmitter
+   */
+  void GetReceivers (Ptr<MobilityModel> senderMobility);
+
   /**
    * List of SpectrumPhy instances attached to the channel.
    */
@@ -116,6 +137,15 @@ private:
    */
   double m_maxLossDb;
 
+  bool m_receiverCulling;  //!< Whether out-of-range receivers are skipped
+  double m_cullingRange;   //!< Maximum distance of a receiver in meters
+
+  PositionGrid m_receiverGrid;            //!< Spatial index of the PHYs with a mobility model
+  std::vector<uint32_t> m_gridEntryPhys;  //!< Index in m_phyList of each entry of m_receiverGrid
+  std::vector<uint32_t> m_unplacedPhys;   //!< Indexes in m_phyList of the PHYs without a mobility model
+  std::vector<uint32_t> m_gridEntries;    //!< Scratch list of the grid entries in range
+  std::vector<uint32_t> m_receivers;      //!< Indexes in m_phyList of the receivers of the current signal
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
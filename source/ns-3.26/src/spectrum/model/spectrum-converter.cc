@@ -39,6 +39,7 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   m_fromSpectrumModel = fromSpectrumModel;
   m_toSpectrumModel = toSpectrumModel;
 
+  m_rowBegin.push_back (0);
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
       std::vector<double> coeffs;
@@ -53,7 +54,21 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
           coeffs.push_back (c);
         }
 
-      m_conversionMatrix.push_back (coeffs);
+      //keep the coefficients from the first to the last non-zero one
+      size_t first = 0;
+      while (first < coeffs.size () && coeffs[first] == 0)
+        {
+          ++first;
+        }
+      size_t last = coeffs.size ();
+      while (last > first && coeffs[last - 1] == 0)
+        {
+          --last;
+        }
+      m_conversionCoefficients.insert (m_conversionCoefficients.end (),
+                                       coeffs.begin () + first, coeffs.begin () + last);
+      m_rowBegin.push_back (m_conversionCoefficients.size ());
+      m_rowFromIndex.push_back (first);
     }
 
 }
@@ -79,21 +94,19 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 
   Values::iterator tvit = tvvf->ValuesBegin ();
 
-
-  for (std::vector<std::vector<double> >::const_iterator toit = m_conversionMatrix.begin ();
-       toit != m_conversionMatrix.end ();
-       ++toit)
+  //the coefficients of a row are added in the same order as with the
+  //whole row, so the result is the same for finite values
+  const double *coeffs = m_conversionCoefficients.empty () ? 0 : &m_conversionCoefficients[0];
+  for (size_t row = 0; row < m_rowFromIndex.size (); ++row)
     {
       NS_ASSERT (tvit != tvvf->ValuesEnd ());
-      Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+      Values::const_iterator fvit = fvvf->ConstValuesBegin () + m_rowFromIndex[row];
+      NS_ASSERT (m_rowFromIndex[row] + m_rowBegin[row + 1] - m_rowBegin[row] <= fvvf->GetSpectrumModel ()->GetNumBands ());
 
       double sum = 0;
-      for (std::vector<double>::const_iterator fromit = toit->begin ();
-           fromit != toit->end ();
-           ++fromit)
+      for (size_t i = m_rowBegin[row]; i != m_rowBegin[row + 1]; ++i)
         {
-          NS_ASSERT (fvit != fvvf->ConstValuesEnd ());
-          sum += (*fvit) * (*fromit);
+          sum += (*fvit) * coeffs[i];
           ++fvit;
         }
       *tvit = sum;
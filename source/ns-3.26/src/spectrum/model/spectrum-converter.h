@@ -78,7 +78,15 @@ private:
    */
   double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
 
-  std::vector<std::vector<double> > m_conversionMatrix; //!< matrix of conversion coefficients
+  /**
+   * Conversion coefficients. Each "to" band only overlaps a few
+   * neighbouring "from" bands, so only the coefficients between the first
+   * and the last non-zero coefficient of each row of the conversion
+   * matrix are stored, row after row.
+   */
+  std::vector<double> m_conversionCoefficients;
+  std::vector<size_t> m_rowBegin;     //!< index in m_conversionCoefficients of the first coefficient of each row, plus the end of the last row
+  std::vector<size_t> m_rowFromIndex; //!< index of the "from" band of the first coefficient of each row
   Ptr<const SpectrumModel> m_fromSpectrumModel;  //!<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    //!<  the SpectrumModel this SpectrumConverter instance can convert to
 
@@ -145,6 +145,9 @@ private:
 
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
+  SpectrumValue m_interf; //!< interference plus noise of the last chunk, kept so that its storage is reused
+  SpectrumValue m_sinr;   //!< SINR of the last chunk, kept so that its storage is reused
+
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
 
 
@@ -28,25 +28,65 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
 SpectrumValue::SpectrumValue ()
+  : m_scale (1)
 {
 }
 
 SpectrumValue::SpectrumValue (Ptr<const SpectrumModel> sof)
   : m_spectrumModel (sof),
-    m_values (sof->GetNumBands ())
+    m_values (sof->GetNumBands ()),
+    m_scale (1)
 {
 
 }
 
+SpectrumValue::SpectrumValue (Ptr<const SpectrumValue> values, double scale)
+  : m_spectrumModel (values->m_spectrumModel),
+    m_shared (values->m_shared ? values->m_shared : values),
+    m_scale (values->m_shared ? values->m_scale * scale : scale)
+{
+  NS_ASSERT (!m_shared->m_shared);
+}
+
+void
+SpectrumValue::Unshare () const
+{
+  if (!m_shared)
+    {
+      return;
+    }
+  m_values = m_shared->m_values;
+  for (Values::iterator it = m_values.begin (); it != m_values.end (); ++it)
+    {
+      *it *= m_scale;
+    }
+  m_shared = 0;
+  m_scale = 1;
+}
+
+const Values&
+SpectrumValue::GetValues (double &scale) const
+{
+  if (m_shared)
+    {
+      scale = m_scale;
+      return m_shared->m_values;
+    }
+  scale = 1;
+  return m_values;
+}
+
 double&
 SpectrumValue::operator[] (size_t index)
 {
+  Unshare ();
   return m_values.at (index);
 }
 
 const double&
 SpectrumValue::operator[] (size_t index) const
 {
+  Unshare ();
   return m_values.at (index);
 }
 
@@ -68,12 +108,14 @@ SpectrumValue::GetSpectrumModel () const
 Values::const_iterator
 SpectrumValue::ConstValuesBegin () const
 {
+  Unshare ();
   return m_values.begin ();
 }
 
 Values::const_iterator
 SpectrumValue::ConstValuesEnd () const
 {
+  Unshare ();
   return m_values.end ();
 }
 
@@ -81,12 +123,14 @@ SpectrumValue::ConstValuesEnd () const
 Values::iterator
 SpectrumValue::ValuesBegin ()
 {
+  Unshare ();
   return m_values.begin ();
 }
 
 Values::iterator
 SpectrumValue::ValuesEnd ()
 {
+  Unshare ();
   return m_values.end ();
 }
 
@@ -106,15 +150,18 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
+  Unshare ();
+  double scale;
+  const Values &values = x.GetValues (scale);
   Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
+  Values::const_iterator it2 = values.begin ();
 
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
 
   while (it1 != m_values.end ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
+      NS_ASSERT ( it2 != values.end ());
+      *it1 += *it2 * scale;
       ++it1;
       ++it2;
     }
@@ -124,6 +171,7 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
+  Unshare ();
   Values::iterator it1 = m_values.begin ();
 
   while (it1 != m_values.end ())
@@ -138,15 +186,18 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
+  Unshare ();
+  double scale;
+  const Values &values = x.GetValues (scale);
   Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
+  Values::const_iterator it2 = values.begin ();
 
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
 
   while (it1 != m_values.end ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
+      NS_ASSERT ( it2 != values.end ());
+      *it1 -= *it2 * scale;
       ++it1;
       ++it2;
     }
@@ -164,15 +215,18 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
+  Unshare ();
+  double scale;
+  const Values &values = x.GetValues (scale);
   Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
+  Values::const_iterator it2 = values.begin ();
 
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
 
   while (it1 != m_values.end ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
+      NS_ASSERT ( it2 != values.end ());
+      *it1 *= *it2 * scale;
       ++it1;
       ++it2;
     }
@@ -182,6 +236,7 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
+  Unshare ();
   Values::iterator it1 = m_values.begin ();
 
   while (it1 != m_values.end ())
@@ -197,15 +252,18 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
+  Unshare ();
+  double scale;
+  const Values &values = x.GetValues (scale);
   Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
+  Values::const_iterator it2 = values.begin ();
 
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
 
   while (it1 != m_values.end ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
+      NS_ASSERT ( it2 != values.end ());
+      *it1 /= *it2 * scale;
       ++it1;
       ++it2;
     }
@@ -215,6 +273,7 @@ SpectrumValue::Divide (const SpectrumValue& x)
 void
 SpectrumValue::Divide (double s)
 {
+  Unshare ();
   NS_LOG_FUNCTION (this << s);
   Values::iterator it1 = m_values.begin ();
 
@@ -231,6 +290,7 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
+  Unshare ();
   Values::iterator it1 = m_values.begin ();
 
   while (it1 != m_values.end ())
@@ -244,6 +304,7 @@ SpectrumValue::ChangeSign ()
 void
 SpectrumValue::ShiftLeft (int n)
 {
+  Unshare ();
   int i = 0;
   while (i < (int) m_values.size () - n)
     {
@@ -261,6 +322,7 @@ SpectrumValue::ShiftLeft (int n)
 void
 SpectrumValue::ShiftRight (int n)
 {
+  Unshare ();
   int i = m_values.size () - 1;
   while (i - n >= 0)
     {
@@ -279,6 +341,7 @@ SpectrumValue::ShiftRight (int n)
 void
 SpectrumValue::Pow (double exp)
 {
+  Unshare ();
   NS_LOG_FUNCTION (this << exp);
   Values::iterator it1 = m_values.begin ();
 
@@ -293,6 +356,7 @@ SpectrumValue::Pow (double exp)
 void
 SpectrumValue::Exp (double base)
 {
+  Unshare ();
   NS_LOG_FUNCTION (this << base);
   Values::iterator it1 = m_values.begin ();
 
@@ -307,6 +371,7 @@ SpectrumValue::Exp (double base)
 void
 SpectrumValue::Log10 ()
 {
+  Unshare ();
   NS_LOG_FUNCTION (this);
   Values::iterator it1 = m_values.begin ();
 
@@ -320,6 +385,7 @@ SpectrumValue::Log10 ()
 void
 SpectrumValue::Log2 ()
 {
+  Unshare ();
   NS_LOG_FUNCTION (this);
   Values::iterator it1 = m_values.begin ();
 
@@ -334,6 +400,7 @@ SpectrumValue::Log2 ()
 void
 SpectrumValue::Log ()
 {
+  Unshare ();
   NS_LOG_FUNCTION (this);
   Values::iterator it1 = m_values.begin ();
 
@@ -348,10 +415,13 @@ double
 Norm (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  double scale;
+  const Values &values = x.GetValues (scale);
+  Values::const_iterator it1 = values.begin ();
+  while (it1 != values.end ())
     {
-      s += (*it1) * (*it1);
+      double v = *it1 * scale;
+      s += v * v;
       ++it1;
     }
   return std::sqrt (s);
@@ -362,10 +432,12 @@ double
 Sum (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  double scale;
+  const Values &values = x.GetValues (scale);
+  Values::const_iterator it1 = values.begin ();
+  while (it1 != values.end ())
     {
-      s += (*it1);
+      s += (*it1 * scale);
       ++it1;
     }
   return s;
@@ -390,12 +462,14 @@ double
 Integral (const SpectrumValue& arg)
 {
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
+  double scale;
+  const Values &values = arg.GetValues (scale);
+  Values::const_iterator vit = values.begin ();
   Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  while (vit != values.end ())
     {
       NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
+      i += (*vit * scale) * (bit->fh - bit->fl);
       ++vit;
       ++bit;
     }
@@ -408,11 +482,8 @@ Integral (const SpectrumValue& arg)
 Ptr<SpectrumValue>
 SpectrumValue::Copy () const
 {
-  Ptr<SpectrumValue> p = Create<SpectrumValue> (m_spectrumModel);
-  *p = *this;
-  return p;
-
-  //  return Copy<SpectrumValue> (*this)
+  // a copy of a SpectrumValue sharing its values shares them as well
+  return Create<SpectrumValue> (*this);
 }
 
 
@@ -661,9 +732,32 @@ SpectrumValue::operator/= (double rhs)
 }
 
 
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& x, double k)
+{
+  Unshare ();
+  double scale;
+  const Values &values = x.GetValues (scale);
+  Values::iterator it1 = m_values.begin ();
+  Values::const_iterator it2 = values.begin ();
+
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+
+  while (it1 != m_values.end ())
+    {
+      NS_ASSERT ( it2 != values.end ());
+      *it1 += (*it2 * scale) * k;
+      ++it1;
+      ++it2;
+    }
+  return *this;
+}
+
+
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
+  Unshare ();
   Values::iterator it1 = m_values.begin ();
 
   while (it1 != m_values.end ())
@@ -80,6 +80,21 @@ public:
 
   SpectrumValue ();
 
+  /**
+   * @brief SpectrumValue constructor sharing the values of another SpectrumValue
+   *
+   * The new instance refers to the values of the given SpectrumValue,
+   * scaled by a flat factor, without copying them. The scaled values
+   * are only written to a private vector the first time that they are
+   * accessed through a non-const method, an iterator or operator[];
+   * the arithmetic operators and Integral, Sum and Norm read the shared
+   * values directly. The shared SpectrumValue must not be modified
+   * while instances refer to it.
+   *
+   * @param values the SpectrumValue whose values are shared
+   * @param scale the flat factor applied to each shared value
+   */
+  SpectrumValue (Ptr<const SpectrumValue> values, double scale);
 
   /**
    * Access value at given frequency index
@@ -409,6 +424,18 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the product of a SpectrumValue and a scalar to *this,
+   * component by component. This gives the same result as
+   * *this += x * k without creating a temporary SpectrumValue.
+   *
+   * @param x the SpectrumValue
+   * @param k the scalar
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double k);
+
 
 
   /**
@@ -592,6 +619,16 @@ private:
    * Applies a Log to each the elements
    */
   void Log ();
+  /**
+   * Write the scaled shared values, if any, to m_values so that
+   * they can be accessed directly.
+   */
+  void Unshare () const;
+  /**
+   * \param scale set to the flat factor to apply to the returned values
+   * \return the shared values if any, m_values otherwise
+   */
+  const Values& GetValues (double &scale) const;
 
   Ptr<const SpectrumModel> m_spectrumModel; //!< The spectrum model
 
@@ -602,8 +639,12 @@ private:
    * on what these values represent (a transmission power density, a
    * propagation loss, etc.).
    *
+   * Empty while m_shared is set.
    */
-  Values m_values;
+  mutable Values m_values;
+
+  mutable Ptr<const SpectrumValue> m_shared; //!< SpectrumValue whose values are shared, if any
+  mutable double m_scale;                   //!< flat factor applied to the shared values
 
 
 };
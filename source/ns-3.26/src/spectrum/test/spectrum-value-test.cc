@@ -223,6 +223,12 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  SpectrumValue tv11 (f), v11 (f);
+  tv11 = v2;
+  tv11.AddScaled (v1, doubleValue);
+  v11 = v2 + v1 * doubleValue;
+  AddTestCase (new SpectrumValueTestCase (tv11, v11, "tv11 = v2, tv11.AddScaled (v1, doubleValue)"), TestCase::QUICK);
+
 
 
 
@@ -241,6 +247,20 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   tv1rs3 = v1 >> 3;
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
+  Ptr<SpectrumValue> pv1 = Create<SpectrumValue> (v1);
+  SpectrumValue sv1 (pv1, doubleValue);
+  SpectrumValue tv12 (f), v12 (f);
+  tv12 = v2 * sv1;
+  v12 = v2 * tv9a;
+  AddTestCase (new SpectrumValueTestCase (tv12, v12, "tv12 = v2 * shared (v1, doubleValue)"), TestCase::QUICK);
+
+  SpectrumValue tv13 (pv1, doubleValue);
+  tv13[0] = 0;
+  SpectrumValue v13 = tv9a;
+  v13[0] = 0;
+  AddTestCase (new SpectrumValueTestCase (tv13, v13, "tv13 = shared (v1, doubleValue), tv13[0] = 0"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (*pv1, v1, "shared v1 after tv13[0] = 0"), TestCase::QUICK);
+
 
 }
 
@@ -328,6 +348,25 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 //   NS_LOG_LOGIC(*res);
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
+  // bands of the "to" model which do not overlap the "from" model
+  std::vector<double> f3;
+  for (f = 0; f <= 10; f += 1)
+    {
+      f3.push_back (f);
+    }
+  Ptr<SpectrumModel> sof3 = Create<SpectrumModel> (f3);
+  SpectrumConverter c13 (sof1, sof3);
+  res = c13.Convert (v1);
+  SpectrumValue t13 (sof3);
+  t13 = 0;
+  for (uint32_t i = 3; i <= 7; i++)
+    {
+      t13[i] = 4;
+    }
+  t13[2] = 2;
+  t13[8] = 2;
+  AddTestCase (new SpectrumValueTestCase (t13, *res, ""), TestCase::QUICK);
+
 
 }
 
@@ -38,11 +38,18 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/object-factory.h"
 #include "HE-wifi-channel.h"
+#include "wifi-profiler.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("HEWifiChannel");
@@ -64,11 +71,60 @@ HEWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&HEWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SharedPacketDelivery",
+                   "If true, all receivers of a frame share one read-only packet instead of "
+                   "getting their own copy.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&HEWifiChannel::m_sharedPacketDelivery),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ReceiverCulling",
+                   "If true, a frame is only delivered to the PHYs within CullingRange of the sender "
+                   "and received above RxPowerFloor; the other PHYs get neither an event nor a copy. "
+                   "The PHYs are located through the CourseChange trace and the velocity of their "
+                   "mobility models, so models that move without reporting a velocity are not supported.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&HEWifiChannel::m_receiverCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingRange",
+                   "The maximum distance (m) of a receiver when ReceiverCulling is enabled.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&HEWifiChannel::m_cullingRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("RxPowerFloor",
+                   "The minimum received power (dBm) of a delivered frame when ReceiverCulling is enabled.",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&HEWifiChannel::m_rxPowerFloorDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("PathLossCache",
+                   "If true, the received power is memoized per (sender, receiver, RU, channel, "
+                   "transmit power) and reused while both nodes are at the positions it was "
+                   "computed for. This must only be enabled with deterministic loss models, and "
+                   "only saves work for nodes that do not move between transmissions.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&HEWifiChannel::m_pathLossCacheEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PathLossCacheSize",
+                   "The maximum number of entries of the path loss cache. The cache is emptied "
+                   "when a new entry does not fit.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&HEWifiChannel::m_pathLossCacheSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AdjacentChannelInterference",
+                   "If true, a frame also reaches the PHYs on other channels as noise, "
+                   "with the power leaked into their channel by the transmit spectral mask "
+                   "(see HeChannelLeakage). Otherwise these PHYs ignore the frame.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&HEWifiChannel::m_adjacentChannelInterference),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 HEWifiChannel::HEWifiChannel ()
+  : m_sharedPacketDelivery (true),
+    m_receiverCulling (false),
+    m_pathLossCacheEnabled (false),
+    m_adjacentChannelInterference (false)
 {
 }
 
@@ -94,57 +150,193 @@ void
 HEWifiChannel::Send (Ptr<HEWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                        WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const
 {
+  WifiProfiler::Scope scope (WifiProfiler::HE_CHANNEL_SEND);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  Ptr<const Packet> shared;
+  if (!m_receiverCulling)
+    {
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          SendToPhy (sender, senderMobility, j, packet, shared, txPowerDbm, txVector, preamble, mpdutype, duration);
+        }
+      return;
+    }
+  m_receiverGrid.GetPhysInRange (m_phyList, senderMobility->GetPosition (), m_cullingRange, m_receivers);
+  for (std::vector<uint32_t>::const_iterator r = m_receivers.begin (); r != m_receivers.end (); r++)
+    {
+      SendToPhy (sender, senderMobility, *r, packet, shared, txPowerDbm, txVector, preamble, mpdutype, duration);
+    }
+}
+
+void
+HEWifiChannel::SendToPhy (Ptr<HEWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                          Ptr<const Packet> packet, Ptr<const Packet> &shared, double txPowerDbm,
+                          WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const
+{
+  Ptr<HEWifiPhy> receiver = m_phyList[j];
+  if (sender == receiver)
+    {
+      return;
+    }
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      if (m_adjacentChannelInterference)
+        {
+          SendLeakage (sender, senderMobility, j, txPowerDbm, txVector, duration);
+        }
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+
+  double rxPowerDbm = GetRxPowerDbm (txPowerDbm, senderMobility, receiverMobility, txVector.GetRu (), receiver->GetChannelNumber ());
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  if (m_receiverCulling && rxPowerDbm < m_rxPowerFloorDbm)
     {
-      if (sender != (*i))
+      return;
+    }
+  Ptr<const Packet> copy = shared;
+  if (copy == 0)
+    {
+      copy = packet->Copy ();
+      if (m_sharedPacketDelivery)
         {
-          //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
- 
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility, txVector.GetRu(), (*i)->GetChannelNumber());
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
-
-          struct HeParameters parameters;
-          parameters.rxPowerDbm = rxPowerDbm;
-          parameters.type = mpdutype;
-          parameters.duration = duration;
-          parameters.txVector = txVector;
-          parameters.preamble = preamble;
-
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &HEWifiChannel::Receive, this,
-                                          j, copy, parameters);
+          shared = copy;
         }
     }
+
+  struct HeParameters parameters;
+  parameters.rxPowerDbm = rxPowerDbm;
+  parameters.type = mpdutype;
+  parameters.duration = duration;
+  parameters.txVector = txVector;
+  parameters.preamble = preamble;
+
+  Simulator::ScheduleWithContext (GetReceiverContext (j),
+                                  delay, &HEWifiChannel::Receive, this,
+                                  j, copy, parameters);
 }
 
 void
-HEWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct HeParameters parameters) const
+HEWifiChannel::SendLeakage (Ptr<HEWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                            double txPowerDbm, WifiTxVector txVector, Time duration) const
+{
+  Ptr<HEWifiPhy> receiver = m_phyList[j];
+  double leakage = m_leakage.GetLeakage (sender->GetChannelNumber (), sender->GetChannelWidth (), txVector.GetRu (),
+                                         receiver->GetChannelNumber (), receiver->GetChannelWidth ());
+  if (leakage == 0)
+    {
+      return;
+    }
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  //The path loss is evaluated on the channel of the sender
+  double rxPowerDbm = GetRxPowerDbm (txPowerDbm, senderMobility, receiverMobility, txVector.GetRu (), sender->GetChannelNumber ())
+    + 10 * std::log10 (leakage);
+  NS_LOG_DEBUG ("leakage: channel " << sender->GetChannelNumber () << " -> " << receiver->GetChannelNumber () <<
+                ", rxPower=" << rxPowerDbm << "dbm");
+  if (m_receiverCulling && rxPowerDbm < m_rxPowerFloorDbm)
+    {
+      return;
+    }
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  Simulator::ScheduleWithContext (GetReceiverContext (j),
+                                  delay, &HEWifiChannel::ReceiveLeakage, this,
+                                  j, rxPowerDbm, duration);
+}
+
+uint32_t
+HEWifiChannel::GetReceiverContext (uint32_t i) const
+{
+  Ptr<Object> dstNetDevice = m_phyList[i]->GetDevice ();
+  if (dstNetDevice == 0)
+    {
+      return 0xffffffff;
+    }
+  return dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+}
+
+bool
+HEWifiChannel::PathLossKey::operator < (const PathLossKey &o) const
+{
+  if (sender != o.sender)
+    {
+      return sender < o.sender;
+    }
+  if (receiver != o.receiver)
+    {
+      return receiver < o.receiver;
+    }
+  if (ru != o.ru)
+    {
+      return ru < o.ru;
+    }
+  if (channelNumber != o.channelNumber)
+    {
+      return channelNumber < o.channelNumber;
+    }
+  return txPowerDbm < o.txPowerDbm;
+}
+
+double
+HEWifiChannel::GetRxPowerDbm (double txPowerDbm, Ptr<MobilityModel> sender, Ptr<MobilityModel> receiver,
+                              uint8_t ru, uint16_t channelNumber) const
+{
+  if (!m_pathLossCacheEnabled)
+    {
+      return m_loss->CalcRxPower (txPowerDbm, sender, receiver, ru, channelNumber);
+    }
+  PathLossKey key;
+  key.sender = PeekPointer (sender);
+  key.receiver = PeekPointer (receiver);
+  key.ru = ru;
+  key.channelNumber = channelNumber;
+  key.txPowerDbm = txPowerDbm;
+  //Not all mobility models report their moves as course changes, so the
+  //entries are checked against the current positions
+  Vector senderPosition = sender->GetPosition ();
+  Vector receiverPosition = receiver->GetPosition ();
+
+  std::map<PathLossKey, PathLossValue>::iterator it = m_pathLossCache.find (key);
+  if (it != m_pathLossCache.end ())
+    {
+      if (IsSamePosition (it->second.senderPosition, senderPosition)
+          && IsSamePosition (it->second.receiverPosition, receiverPosition))
+        {
+          return it->second.rxPowerDbm;
+        }
+    }
+  else if (m_pathLossCache.size () >= m_pathLossCacheSize)
+    {
+      m_pathLossCache.clear ();
+    }
+  PathLossValue &value = m_pathLossCache[key];
+  value.rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, sender, receiver, ru, channelNumber);
+  value.senderPosition = senderPosition;
+  value.receiverPosition = receiverPosition;
+  return value.rxPowerDbm;
+}
+
+bool
+HEWifiChannel::IsSamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+void
+HEWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, struct HeParameters parameters) const
 {
   m_phyList[i]->StartReceivePreambleAndHeader (packet, parameters.rxPowerDbm, parameters.txVector, parameters.preamble, parameters.type, parameters.duration);
 }
 
+void
+HEWifiChannel::ReceiveLeakage (uint32_t i, double rxPowerDbm, Time duration) const
+{
+  m_phyList[i]->StartReceiveLeakage (rxPowerDbm, duration);
+}
+
 uint32_t
 HEWifiChannel::GetNDevices (void) const
 {
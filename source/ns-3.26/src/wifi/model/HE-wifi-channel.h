@@ -35,6 +35,7 @@
 #define HE_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -42,11 +43,14 @@
 #include "wifi-preamble.h"
 #include "wifi-tx-vector.h"
 #include "HE-wifi-phy.h"
+#include "he-channel-leakage.h"
 #include "ns3/nstime.h"
+#include "ns3/position-grid.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 
@@ -111,7 +115,14 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from WifiPhy::Send. HEWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
-   * e.g. PHYs that are operating on the same channel.
+   * e.g. PHYs that are operating on the same channel. With
+   * AdjacentChannelInterference, the PHYs on other channels get the
+   * leaked power as noise.
+   *
+   * HE MU padding is not carried in the packet (see
+   * WifiTxVector::SetPadding), only in the duration. With
+   * SharedPacketDelivery, all receivers get the same read-only packet;
+   * a receiving PHY copies it only when it passes it up to the MAC.
    */
   void Send (Ptr<HEWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
@@ -144,11 +155,108 @@ private:
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, struct HeParameters parameters) const;
+  void Receive (uint32_t i, Ptr<const Packet> packet, struct HeParameters parameters) const;
+  /**
+   * This method is scheduled by Send for each HEWifiPhy on another
+   * channel that gets power leaked by the transmission.
+   *
+   * \param i index of the corresponding HEWifiPhy in the PHY list
+   * \param rxPowerDbm the leaked receive power in dBm
+   * \param duration the duration of the transmission
+   */
+  void ReceiveLeakage (uint32_t i, double rxPowerDbm, Time duration) const;
+  /**
+   * Schedule the reception of a transmission by a PHY, or the leakage
+   * into its channel if it operates on another channel than the sender.
+   *
+   * \param sender the transmitting PHY
+   * \param senderMobility the mobility model of the transmitter
+   * \param j index of the receiving HEWifiPhy in the PHY list
+   * \param packet the packet being sent
+   * \param shared the packet already delivered to the previous receivers
+   *        with SharedPacketDelivery, or 0
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType
+   * \param duration the transmission duration associated to the packet
+   */
+  void SendToPhy (Ptr<HEWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                  Ptr<const Packet> packet, Ptr<const Packet> &shared, double txPowerDbm,
+                  WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
+  /**
+   * Schedule the leakage of a transmission into the channel of a PHY
+   * operating on another channel than the sender.
+   *
+   * \param sender the transmitting PHY
+   * \param senderMobility the mobility model of the transmitter
+   * \param j index of the receiving HEWifiPhy in the PHY list
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param duration the transmission duration associated to the packet
+   */
+  void SendLeakage (Ptr<HEWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                    double txPowerDbm, WifiTxVector txVector, Time duration) const;
+  /**
+   * \param i index of a HEWifiPhy in the PHY list
+   * \return the id of the node of the PHY, or 0xffffffff if it has no device
+   */
+  uint32_t GetReceiverContext (uint32_t i) const;
+
+  /**
+   * Return the received power of a transmission, from the path loss
+   * cache if it is enabled.
+   *
+   * \param txPowerDbm the transmit power in dBm
+   * \param sender the mobility model of the transmitter
+   * \param receiver the mobility model of the receiver
+   * \param ru the RU bitmap of the transmission
+   * \param channelNumber the channel number of the receiver
+   *
+   * \return the received power in dBm
+   */
+  double GetRxPowerDbm (double txPowerDbm, Ptr<MobilityModel> sender, Ptr<MobilityModel> receiver,
+                        uint8_t ru, uint16_t channelNumber) const;
+  /**
+   * \param a the first position
+   * \param b the second position
+   * \return true if both positions are exactly the same
+   */
+  static bool IsSamePosition (const Vector &a, const Vector &b);
+
+  /// Key of the path loss cache
+  struct PathLossKey
+  {
+    const MobilityModel *sender;   //!< mobility model of the transmitter
+    const MobilityModel *receiver; //!< mobility model of the receiver
+    uint8_t ru;                    //!< RU bitmap
+    uint16_t channelNumber;        //!< channel number
+    double txPowerDbm;             //!< transmit power in dBm
+
+    bool operator < (const PathLossKey &o) const;
+  };
+  /// Value of the path loss cache
+  struct PathLossValue
+  {
+    double rxPowerDbm;             //!< received power in dBm
+    Vector senderPosition;         //!< position of the transmitter when computed
+    Vector receiverPosition;       //!< position of the receiver when computed
+  };
 
   PhyList m_phyList;                   //!< List of HEWifiPhys connected to this HEWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  bool m_sharedPacketDelivery;         //!< Whether all receivers share one packet
+  bool m_receiverCulling;              //!< Whether out-of-range receivers are skipped
+  double m_cullingRange;               //!< Maximum distance of a receiver in meters
+  double m_rxPowerFloorDbm;            //!< Minimum received power of a delivered frame
+  mutable PositionGrid m_receiverGrid; //!< Spatial index of the PHYs
+  mutable std::vector<uint32_t> m_receivers; //!< PHYs within CullingRange of the current sender
+  bool m_pathLossCacheEnabled;         //!< Whether received powers are memoized
+  uint32_t m_pathLossCacheSize;        //!< Maximum number of memoized received powers
+  mutable std::map<PathLossKey, PathLossValue> m_pathLossCache;           //!< Memoized received powers
+  bool m_adjacentChannelInterference;  //!< Whether PHYs on other channels get the leaked power
+  mutable HeChannelLeakage m_leakage;  //!< Leakage between channels
 };
 
 } //namespace ns3
@@ -44,6 +44,8 @@
 #include "ns3/rng-seed-manager.h"
 #include "ns3/wifi-mac-header.h"
 #include "ns3/per-tag.h"
+#include "ns3/pointer.h"
+#include "he-link-abstraction.h"
 
 #include <cmath>
 
@@ -60,6 +62,12 @@ HEWifiPhy::GetTypeId (void)
     .SetParent<WifiPhy> ()
     .SetGroupName ("Wifi")
     .AddConstructor<HEWifiPhy> ()
+    .AddAttribute ("LinkAbstraction",
+                   "If set, the PER of a PPDU is obtained from its effective SINR through this "
+                   "link abstraction, instead of the error rate of each chunk of the PPDU.",
+                   PointerValue (),
+                   MakePointerAccessor (&HEWifiPhy::m_linkAbstraction),
+                   MakePointerChecker<HELinkAbstraction> ())
   ;
   return tid;
 }
@@ -79,6 +87,7 @@ HEWifiPhy::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_channel = 0;
+  m_linkAbstraction = 0;
 }
 
 bool
@@ -273,7 +282,7 @@ HEWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-HEWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
+HEWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                             double rxPowerDbm,
                                             WifiTxVector txVector,
                                             enum WifiPreamble preamble,
@@ -291,7 +300,6 @@ HEWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
   Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector, preamble);
   enum WifiPhy::State phyState = m_state->GetState ();
   bool receiveTbMpdu = false;
-  packet->RemovePaddingAtEnd();
   Ptr<InterferenceHelper::Event> event;
   event = m_interference.Add (packet->GetSize (),
                               txVector,
@@ -415,7 +423,12 @@ HEWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
               NotifyRxBegin (packet);
               m_interference.NotifyRxStart ();
 
-              if (preamble != WIFI_PREAMBLE_NONE)
+              if (preamble != WIFI_PREAMBLE_NONE && m_linkAbstraction != 0)
+                {
+                  //The PLCP header is not modeled, only check the mode
+                  CheckPayloadMode (packet, txVector.GetMode ());
+                }
+              else if (preamble != WIFI_PREAMBLE_NONE)
                 {
                   Simulator::Schedule (preambleAndHeaderDuration, &HEWifiPhy::StartReceivePacket, this,
                                                           packet, txVector, preamble, mpdutype, event);
@@ -428,7 +441,12 @@ HEWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
               NotifyRxBegin (packet);
               m_interference.NotifyRxStart ();
 
-              if (preamble != WIFI_PREAMBLE_NONE)
+              if (preamble != WIFI_PREAMBLE_NONE && m_linkAbstraction != 0)
+                {
+                  //The PLCP header is not modeled, only check the mode
+                  CheckPayloadMode (packet, txVector.GetMode ());
+                }
+              else if (preamble != WIFI_PREAMBLE_NONE)
                 {
                   NS_ASSERT (m_endPlcpRxEvent.IsExpired ());
                   m_endPlcpRxEvent = Simulator::Schedule (preambleAndHeaderDuration, &HEWifiPhy::StartReceivePacket, this,
@@ -483,7 +501,26 @@ maybeCcaBusy:
 }
 
 void
-HEWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+HEWifiPhy::StartReceiveLeakage (double rxPowerDbm, Time rxDuration)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm << rxDuration);
+  rxPowerDbm += GetRxGain ();
+  m_interference.AddForeignSignal (rxDuration, DbmToW (rxPowerDbm));
+  if (m_state->IsStateSleep () || m_state->IsStateSwitching ())
+    {
+      //As for a packet, the energy is tracked but CCA is not updated
+      NS_LOG_DEBUG ("no CCA update while sleeping or switching channel");
+      return;
+    }
+  Time delayUntilCcaEnd = m_interference.GetEnergyDuration (DbmToW (GetCcaMode1Threshold ()));
+  if (!delayUntilCcaEnd.IsZero ())
+    {
+      m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+    }
+}
+
+void
+HEWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble,
                                  enum mpduType mpdutype,
@@ -503,17 +540,7 @@ HEWifiPhy::StartReceivePacket (Ptr<Packet> packet,
 #endif
     if (1)
       {
-      if (IsModeSupported (txMode) || IsMcsSupported (txMode))
-        {
-          NS_LOG_DEBUG ("receiving plcp payload"); //endReceive is already scheduled
-          m_plcpSuccess = true;
-        }
-      else //mode is not allowed
-        {
-          NS_LOG_DEBUG ("drop packet because it was sent using an unsupported mode (" << txMode << ")");
-          NotifyRxDrop (packet);
-          m_plcpSuccess = false;
-        }
+      CheckPayloadMode (packet, txMode);
     }
   else //plcp reception failed
     {
@@ -524,6 +551,22 @@ HEWifiPhy::StartReceivePacket (Ptr<Packet> packet,
     }
 }
 
+void
+HEWifiPhy::CheckPayloadMode (Ptr<const Packet> packet, WifiMode txMode)
+{
+  if (IsModeSupported (txMode) || IsMcsSupported (txMode))
+    {
+      NS_LOG_DEBUG ("receiving plcp payload"); //endReceive is already scheduled
+      m_plcpSuccess = true;
+    }
+  else //mode is not allowed
+    {
+      NS_LOG_DEBUG ("drop packet because it was sent using an unsupported mode (" << txMode << ")");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+    }
+}
+
 void
 HEWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, WifiPreamble preamble)
 {
@@ -611,16 +654,25 @@ HEWifiPhy::UnregisterListener (WifiPhyListener *listener)
 }
 
 void
-HEWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event)
+HEWifiPhy::EndReceive (Ptr<const Packet> sharedPacket, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event)
 {
-  NS_LOG_FUNCTION (this << packet << event);
+  NS_LOG_FUNCTION (this << sharedPacket << event);
+  //The channel may deliver the same packet to all receivers
+  Ptr<Packet> packet = sharedPacket->Copy ();
   NS_ASSERT (IsStateRx ());
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
   Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
 
   struct InterferenceHelper::SnrPer snrPer;
 
-  snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
+  if (m_linkAbstraction != 0)
+    {
+      snrPer = m_interference.CalculateEffectiveSnrPer (event, m_linkAbstraction);
+    }
+  else
+    {
+      snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
+    }
   if (packet->GetSize() < 150){
     snrPer.per = 0;
   }
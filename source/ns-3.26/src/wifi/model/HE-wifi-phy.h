@@ -40,6 +40,7 @@
 namespace ns3 {
 
 class HEWifiChannel;
+class HELinkAbstraction;
 
 /**
  * \brief 802.11 PHY layer model
@@ -55,6 +56,11 @@ class HEWifiChannel;
  * model as provided by the ns3::PropagationLossModel
  * and ns3::PropagationDelayModel classes, both of which are
  * members of the ns3::HEWifiChannel class.
+ *
+ * If a LinkAbstraction is set, the PLCP header reception is not
+ * modeled (no StartReceivePacket event) and the PER of the payload is
+ * derived from its effective SINR on the RU in one pass, see
+ * ns3::HELinkAbstraction.
  */
 class HEWifiPhy : public WifiPhy
 {
@@ -74,19 +80,29 @@ public:
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, which may be shared with other receivers
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType.
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreambleAndHeader (Ptr<Packet> packet,
+  void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                       double rxPowerDbm,
                                       WifiTxVector txVector,
                                       WifiPreamble preamble,
                                       enum mpduType mpdutype,
                                       Time rxDuration);
+  /**
+   * Power of a transmission on another channel leaks into the channel
+   * of this PHY. It is added to the InterferenceHelper as noise over the
+   * whole channel, and may make CCA busy unless the PHY is sleeping or
+   * switching channel.
+   *
+   * \param rxPowerDbm the leaked receive power in dBm
+   * \param rxDuration the duration of the transmission
+   */
+  void StartReceiveLeakage (double rxPowerDbm, Time rxDuration);
   /**
    * Starting receiving the payload of a packet (i.e. the first bit of the packet has arrived).
    *
@@ -96,7 +112,7 @@ public:
    * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType.
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
                            enum mpduType mpdutype,
@@ -120,16 +136,26 @@ protected:
 
 private:
   /**
-   * The last bit of the packet has arrived.
+   * Check that the mode of a PPDU whose PLCP header was received is
+   * supported, and drop the packet otherwise.
+   *
+   * \param packet the packet being received
+   * \param txMode the mode of the payload
+   */
+  void CheckPayloadMode (Ptr<const Packet> packet, WifiMode txMode);
+  /**
+   * The last bit of the packet has arrived. The packet is copied before
+   * it is tagged and passed up.
    *
    * \param packet the packet that the last bit has arrived
    * \param preamble the preamble of the arriving packet
    * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType.
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event);
 
   Ptr<HEWifiChannel> m_channel;        //!< HEWifiChannel that this HEWifiPhy is connected to
+  Ptr<HELinkAbstraction> m_linkAbstraction; //!< Link abstraction, if the PER is abstracted
 };
 
 } //namespace ns3
@@ -58,6 +58,53 @@ NS_LOG_COMPONENT_DEFINE ("ApWifiMac");
 
 NS_OBJECT_ENSURE_REGISTERED (ApWifiMac);
 
+/**
+ * The per-station OFDMA queues are granted access by the RRM manager and
+ * never contend for the medium. Rather than one DcfState each, they share
+ * this passive one, which relays the channel notifications to all of them.
+ */
+class ApWifiMac::OfdmaDcf : public DcfState
+{
+public:
+  OfdmaDcf (ApWifiMac * mac)
+    : m_mac (mac)
+  {
+  }
+
+  virtual bool IsEdca (void) const
+  {
+    return true;
+  }
+
+private:
+  virtual void DoNotifyAccessGranted (void)
+  {
+    NS_FATAL_ERROR ("The OFDMA queues do not request access");
+  }
+  virtual void DoNotifyInternalCollision (void)
+  {
+    NS_FATAL_ERROR ("The OFDMA queues do not request access");
+  }
+  virtual void DoNotifyCollision (void)
+  {
+    NS_FATAL_ERROR ("The OFDMA queues do not request access");
+  }
+  virtual void DoNotifyChannelSwitching (void)
+  {
+    m_mac->NotifyOfdmaQueues (&EdcaTxopN::NotifyChannelSwitching);
+  }
+  virtual void DoNotifySleep (void)
+  {
+    m_mac->NotifyOfdmaQueues (&EdcaTxopN::NotifySleep);
+  }
+  virtual void DoNotifyWakeUp (void)
+  {
+    m_mac->NotifyOfdmaQueues (&EdcaTxopN::NotifyWakeUp);
+  }
+
+  ApWifiMac *m_mac;
+};
+
 TypeId
 ApWifiMac::GetTypeId (void)
 {
@@ -113,6 +160,9 @@ ApWifiMac::ApWifiMac ()
   m_beaconDca->SetManager (m_dcfManager);
   m_beaconDca->SetTxMiddle (m_txMiddle);
 
+  m_ofdmaDcf = new ApWifiMac::OfdmaDcf (this);
+  m_dcfManager->AddPassive (m_ofdmaDcf);
+
   //Let the lower layers know that we are acting as an AP.
   SetTypeOfStation (AP);
 
@@ -125,12 +175,25 @@ ApWifiMac::GetMacLow(void) const
   return m_low;
 }
 
+Ptr<EdcaTxopN>
+ApWifiMac::GetStationQueue (Mac48Address address, enum AcIndex ac)
+{
+  std::map<uint16_t, EdcaStaQueues>::iterator it = m_ofdmaMap.find (GetAid (address));
+  if (it == m_ofdmaMap.end ())
+    {
+      return 0;
+    }
+  return it->second[ac];
+}
+
 ApWifiMac::~ApWifiMac ()
 {
   NS_LOG_FUNCTION (this);
   m_staList.clear();
   m_nonErpStations.clear ();
   m_nonHtStations.clear ();
+  delete m_ofdmaDcf;
+  m_ofdmaDcf = 0;
 }
 
 void
@@ -645,7 +708,8 @@ ApWifiMac::SetupStationEdcaQueue (uint16_t aid, Mac48Address mac, enum AcIndex a
   edca->SetHeSupported(true);
   edca->SetAid(mac, aid);
   edca->SetLow (m_low);
-  edca->SetManager (m_dcfManager);
+  //The queue does not contend for the medium: m_ofdmaDcf relays the
+  //channel notifications to it
   edca->SetTxMiddle (m_txMiddle);
   edca->SetTxOkCallback (MakeCallback (&ApWifiMac::TxOk, this));
   edca->SetTxFailedCallback (MakeCallback (&ApWifiMac::TxFailed, this));
@@ -653,8 +717,14 @@ ApWifiMac::SetupStationEdcaQueue (uint16_t aid, Mac48Address mac, enum AcIndex a
   edca->SetWifiRemoteStationManager(m_stationManager);
   edca->CompleteConfig ();
 
-  Ptr<MsduStandardAggregator> msduAggregator = CreateObject<MsduStandardAggregator> ();
-  edca->SetMsduAggregator (msduAggregator);
+  edca->SetOfdmaAccessRequestCallback (MakeCallback (&ApWifiMac::NotifyOfdmaAccessRequest, this));
+
+  //The A-MSDU aggregator holds no per-station state
+  if (m_ofdmaMsduAggregator == 0)
+    {
+      m_ofdmaMsduAggregator = CreateObject<MsduStandardAggregator> ();
+    }
+  edca->SetMsduAggregator (m_ofdmaMsduAggregator);
   Ptr<MpduStandardAggregator> mpduAggregator = CreateObject<MpduStandardAggregator> ();
   edca->SetMpduAggregator (mpduAggregator);
 #if 0
@@ -693,6 +763,26 @@ ApWifiMac::SetupStationQueue(uint16_t aid, Mac48Address mac)
   m_ofdmaMap.insert(std::make_pair(aid, edcaList));
 }
 
+void
+ApWifiMac::NotifyOfdmaQueues (void (EdcaTxopN::*notify) (void))
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<uint16_t, EdcaStaQueues>::iterator i = m_ofdmaMap.begin (); i != m_ofdmaMap.end (); i++)
+    {
+      for (EdcaStaQueues::iterator j = i->second.begin (); j != i->second.end (); j++)
+        {
+          (PeekPointer (*j)->*notify) ();
+        }
+    }
+}
+
+void
+ApWifiMac::NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac)
+{
+  NS_LOG_FUNCTION (this << aid << ac);
+  m_stationManager->NotifyOfdmaAccessRequest (aid, ac);
+}
+
 void
 ApWifiMac::SendAssocResp (Mac48Address to, bool success)
 {
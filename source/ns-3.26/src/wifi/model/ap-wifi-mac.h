@@ -141,6 +141,14 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
   virtual Ptr<MacLow> GetMacLow (void) const;
+  /**
+   * \param address the address of an associated HE station
+   * \param ac the access category
+   *
+   * \return the OFDMA queue of the station for this access category, or
+   *         0 if the station has none
+   */
+  Ptr<EdcaTxopN> GetStationQueue (Mac48Address address, enum AcIndex ac);
 
 private:
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
@@ -285,6 +293,20 @@ private:
   void SetupStationQueue(uint16_t aid, Mac48Address mac);
   Ptr<EdcaTxopN> SetupStationEdcaQueue (uint16_t aid, Mac48Address mac, enum AcIndex ac);
   typedef std::vector<Ptr<EdcaTxopN>> EdcaStaQueues;
+  /**
+   * Call a notification method on every OFDMA queue.
+   *
+   * \param notify the EdcaTxopN method to call
+   */
+  void NotifyOfdmaQueues (void (EdcaTxopN::*notify) (void));
+  /**
+   * Forward to the station manager that the OFDMA queue of a station
+   * has data to send.
+   *
+   * \param aid the AID of the station
+   * \param ac the access category of the queue
+   */
+  void NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac);
 
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
@@ -300,6 +322,9 @@ private:
   std::list<Mac48Address> m_nonHtStations;   //!< List of all non-HT stations currently associated to the AP
   std::map<Mac48Address, uint16_t> m_aidMap; //!< Map between AID and Mac address
   std::map<uint16_t, EdcaStaQueues> m_ofdmaMap; //!< Map between AID and Mac address
+  class OfdmaDcf;
+  OfdmaDcf *m_ofdmaDcf;                      //!< Channel access state shared by the OFDMA queues
+  Ptr<MsduAggregator> m_ofdmaMsduAggregator; //!< A-MSDU aggregator shared by the OFDMA queues
   bool m_enableNonErpProtection;             //!< Flag whether protection mechanism is used or not when non-ERP STAs are present within the BSS
   uint8_t   m_color;                         // Color code for BSS
 };
@@ -62,10 +62,11 @@ BlockAckCache::UpdateWithMpdu (const WifiMacHeader *hdr)
             }
           m_winStart = (m_winStart + delta) % 4096;
           m_winEnd = seqNumber;
+          m_bitmap[seqNumber % 64] = 0;
 
           WINSIZE_ASSERT;
         }
-      m_bitmap[seqNumber] |= (0x0001 << hdr->GetFragmentNumber ());
+      m_bitmap[seqNumber % 64] |= (0x0001 << hdr->GetFragmentNumber ());
     }
 }
 
@@ -102,12 +103,16 @@ void
 BlockAckCache::ResetPortionOfBitmap (uint16_t start, uint16_t end)
 {
   NS_LOG_FUNCTION (this << start << end);
-  uint32_t i = start;
-  for (; i != end; i = (i + 1) % 4096)
+  uint32_t n = (end - start + 4096) % 4096 + 1;
+  if (n >= 64)
     {
-      m_bitmap[i] = 0;
+      memset (m_bitmap, 0, sizeof (m_bitmap));
+      return;
+    }
+  for (uint32_t i = start; n > 0; i = (i + 1) % 4096, n--)
+    {
+      m_bitmap[i % 64] = 0;
     }
-  m_bitmap[i] = 0;
 }
 
 bool
@@ -127,16 +132,17 @@ BlockAckCache::FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader)
     }
   else if (blockAckHeader->IsCompressed ())
     {
+      //Only the sequence numbers of the window are kept
       uint32_t i = blockAckHeader->GetStartingSequence ();
       uint32_t end = (i + m_winSize - 1) % 4096;
       for (; i != end; i = (i + 1) % 4096)
         {
-          if (m_bitmap[i] == 1)
+          if (IsInWindow (i) && m_bitmap[i % 64] == 1)
             {
               blockAckHeader->SetReceivedPacket (i);
             }
         }
-      if (m_bitmap[i] == 1)
+      if (IsInWindow (i) && m_bitmap[i % 64] == 1)
         {
           blockAckHeader->SetReceivedPacket (i);
         }
@@ -58,7 +58,12 @@ private:
   uint8_t m_winSize;
   uint16_t m_winEnd;
 
-  uint16_t m_bitmap[4096];
+  /**
+   * Received fragments of the sequence numbers of the window. The window
+   * is never larger than 64 MPDUs (the size of a compressed BlockAck
+   * bitmap), so sequence number seq is stored at index seq % 64.
+   */
+  uint16_t m_bitmap[64];
 };
 
 } //namespace ns3
@@ -63,6 +63,12 @@ Bar::Bar (Ptr<const Packet> bar, Mac48Address recipient, uint8_t tid, bool immed
   NS_LOG_FUNCTION (this << bar << recipient << static_cast<uint32_t> (tid) << immediate);
 }
 
+BlockAckManager::RetryScoreboard::RetryScoreboard ()
+  : total (0)
+{
+  memset (count, 0, sizeof (count));
+}
+
 BlockAckManager::BlockAckManager ()
 {
   NS_LOG_FUNCTION (this);
@@ -74,6 +80,7 @@ BlockAckManager::~BlockAckManager ()
   m_queue = 0;
   m_agreements.clear ();
   m_retryPackets.clear ();
+  m_retryScoreboards.clear ();
 }
 
 bool
@@ -145,17 +152,19 @@ BlockAckManager::DestroyAgreement (Mac48Address recipient, uint8_t tid)
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
   if (it != m_agreements.end ())
     {
-      for (std::list<PacketQueueI>::iterator i = m_retryPackets.begin (); i != m_retryPackets.end (); )
+      for (std::list<PacketQueueI>::iterator i = m_retryPackets.begin ();
+           i != m_retryPackets.end () && GetNRetryEntries (recipient, tid) > 0; )
         {
           if ((*i)->hdr.GetAddr1 () == recipient && (*i)->hdr.GetQosTid () == tid)
             {
-              i = m_retryPackets.erase (i);
+              i = EraseFromRetryQueue (i);
             }
           else
             {
               i++;
             }
         }
+      m_retryScoreboards.erase (std::make_pair (recipient, tid));
       m_agreements.erase (it);
       //remove scheduled bar
       for (std::list<Bar>::iterator i = m_bars.begin (); i != m_bars.end (); )
@@ -217,23 +226,23 @@ BlockAckManager::StorePacket (Ptr<const Packet> packet, const WifiMacHeader &hdr
   Item item (packet, hdr, tStamp);
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (it != m_agreements.end ());
-  PacketQueueI queueIt = it->second.second.begin ();
-  for (; queueIt != it->second.second.end (); )
+  //The queue of an agreement is sorted by sequence number and packets are
+  //mostly stored in order, so look for the insertion point from the back
+  PacketQueueI queueIt = it->second.second.end ();
+  while (queueIt != it->second.second.begin ())
     {
-      if (((hdr.GetSequenceNumber () - queueIt->hdr.GetSequenceNumber () + 4096) % 4096) > 2047)
+      PacketQueueI prev = queueIt;
+      prev--;
+      if (((hdr.GetSequenceNumber () - prev->hdr.GetSequenceNumber () + 4096) % 4096) > 2047)
         {
-          queueIt = it->second.second.insert (queueIt, item);
-          break;
+          queueIt = prev;
         }
       else
         {
-          queueIt++;
+          break;
         }
     }
-  if (queueIt == it->second.second.end ())
-    {
-      it->second.second.push_back (item);
-    }
+  it->second.second.insert (queueIt, item);
 }
 
 void
@@ -275,7 +284,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
               //Standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
               agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              it = EraseFromRetryQueue (it);
               continue;
             }
           else if ((*it)->hdr.GetSequenceNumber () > (agreement->second.first.GetStartingSequence () + 63) % 4096)
@@ -314,7 +323,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
               AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
               i->second.second.erase (*it);
             }
-          it = m_retryPackets.erase (it);
+          it = EraseFromRetryQueue (it);
           NS_LOG_DEBUG ("Removed one packet, retry buffer size = " << m_retryPackets.size () );
           break;
         }
@@ -390,6 +399,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
   CleanupBuffers ();
   AgreementsI agreement = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (agreement != m_agreements.end ());
+  if (GetNRetryEntries (recipient, tid) == 0)
+    {
+      return packet;
+    }
   std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
@@ -404,7 +417,7 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
               //standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
               agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              it = EraseFromRetryQueue (it);
               it--;
               continue;
             }
@@ -445,6 +458,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
 bool
 BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
+  if (!AlreadyExists (seqnumber, recipient, tid))
+    {
+      return false;
+    }
 
   std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
@@ -462,7 +479,7 @@ BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seq
           AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
           i->second.second.erase ((*it));
 
-          m_retryPackets.erase (it);
+          EraseFromRetryQueue (it);
           NS_LOG_DEBUG ("Removed Packet from retry queue = " << hdr.GetSequenceNumber () << " " << (uint32_t) tid << " " << recipient << " Buffer Size = " << m_retryPackets.size ());
           return true;
         }
@@ -521,7 +538,7 @@ BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) co
   NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid));
   uint32_t nPackets = 0;
   uint16_t currentSeq = 0;
-  if (ExistsAgreement (recipient, tid))
+  if (ExistsAgreement (recipient, tid) && GetNRetryEntries (recipient, tid) > 0)
     {
       std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
       while (it != m_retryPackets.end ())
@@ -567,21 +584,15 @@ BlockAckManager::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> mana
 bool
 BlockAckManager::AlreadyExists (uint16_t currentSeq, Mac48Address recipient, uint8_t tid)
 {
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
-    {
-      NS_LOG_FUNCTION (this << (*it)->hdr.GetType ());
-      if (!(*it)->hdr.IsQosData ())
-        {
-          NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-        }
-      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && currentSeq == (*it)->hdr.GetSequenceNumber ())
-        {
-          return true;
-        }
-      it++;
-    }
-  return false;
+  RetryScoreboards::const_iterator it = m_retryScoreboards.find (std::make_pair (recipient, tid));
+  return it != m_retryScoreboards.end () && it->second.count[currentSeq] > 0;
+}
+
+uint32_t
+BlockAckManager::GetNRetryEntries (Mac48Address recipient, uint8_t tid) const
+{
+  RetryScoreboards::const_iterator it = m_retryScoreboards.find (std::make_pair (recipient, tid));
+  return (it == m_retryScoreboards.end ()) ? 0 : it->second.total;
 }
 
 void
@@ -900,13 +911,15 @@ BlockAckManager::CleanupBuffers (void)
           else
             {
               /* remove retry packet iterator if it's present in retry queue */
-              for (std::list<PacketQueueI>::iterator it = m_retryPackets.begin (); it != m_retryPackets.end (); )
+              for (std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
+                   it != m_retryPackets.end ()
+                   && AlreadyExists (i->hdr.GetSequenceNumber (), j->second.first.GetPeer (), j->second.first.GetTid ()); )
                 {
                   if ((*it)->hdr.GetAddr1 () == j->second.first.GetPeer ()
                       && (*it)->hdr.GetQosTid () == j->second.first.GetTid ()
                       && (*it)->hdr.GetSequenceNumber () == i->hdr.GetSequenceNumber ())
                     {
-                      it = m_retryPackets.erase (it);
+                      it = EraseFromRetryQueue (it);
                     }
                   else
                     {
@@ -959,6 +972,10 @@ uint16_t
 BlockAckManager::GetSeqNumOfNextRetryPacket (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid));
+  if (GetNRetryEntries (recipient, tid) == 0)
+    {
+      return 4096;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
@@ -991,6 +1008,9 @@ void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
   NS_LOG_INFO ("Adding to retry queue " << (*item).hdr.GetSequenceNumber ());
+  RetryScoreboard &scoreboard = m_retryScoreboards[std::make_pair (item->hdr.GetAddr1 (), item->hdr.GetQosTid ())];
+  scoreboard.count[item->hdr.GetSequenceNumber ()]++;
+  scoreboard.total++;
   if (m_retryPackets.size () == 0)
     {
       m_retryPackets.push_back (item);
@@ -1016,4 +1036,15 @@ BlockAckManager::InsertInRetryQueue (PacketQueueI item)
     }
 }
 
+std::list<BlockAckManager::PacketQueueI>::iterator
+BlockAckManager::EraseFromRetryQueue (std::list<PacketQueueI>::iterator it)
+{
+  RetryScoreboards::iterator scoreboard = m_retryScoreboards.find (std::make_pair ((*it)->hdr.GetAddr1 (), (*it)->hdr.GetQosTid ()));
+  NS_ASSERT (scoreboard != m_retryScoreboards.end ());
+  NS_ASSERT (scoreboard->second.count[(*it)->hdr.GetSequenceNumber ()] > 0);
+  scoreboard->second.count[(*it)->hdr.GetSequenceNumber ()]--;
+  scoreboard->second.total--;
+  return m_retryPackets.erase (it);
+}
+
 } //namespace ns3
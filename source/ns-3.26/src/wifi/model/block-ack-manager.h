@@ -432,6 +432,38 @@ private:
    * This method ensures packets are retransmitted in the correct order.
    */
   void InsertInRetryQueue (PacketQueueI item);
+  /**
+   * Remove an entry from the retransmission queue.
+   *
+   * \param it the entry
+   *
+   * \return the entry following the removed one
+   */
+  std::list<PacketQueueI>::iterator EraseFromRetryQueue (std::list<PacketQueueI>::iterator it);
+  /**
+   * \param recipient the recipient
+   * \param tid the TID
+   *
+   * \return the number of entries of the retransmission queue for the
+   *         recipient and TID
+   */
+  uint32_t GetNRetryEntries (Mac48Address recipient, uint8_t tid) const;
+
+  /**
+   * Scoreboard of the retransmission queue entries of a (recipient, tid)
+   * pair, indexed by sequence number, so that membership tests do not
+   * walk the retransmission queue.
+   */
+  struct RetryScoreboard
+  {
+    RetryScoreboard ();
+    uint32_t total;       //!< number of entries
+    uint8_t count[4096];  //!< number of entries (fragments) per sequence number
+  };
+  /**
+   * typedef for a map between (recipient, tid) and retry scoreboard.
+   */
+  typedef std::map<std::pair<Mac48Address, uint8_t>, RetryScoreboard> RetryScoreboards;
 
   /**
    * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
@@ -447,6 +479,7 @@ private:
    * frame.
    */
   std::list<PacketQueueI> m_retryPackets;
+  RetryScoreboards m_retryScoreboards; //!< retry queue entries per (recipient, tid)
   std::list<Bar> m_bars;
 
   uint8_t m_blockAckThreshold;
@@ -427,6 +427,13 @@ DcfManager::Add (DcfState *dcf)
   m_states.push_back (dcf);
 }
 
+void
+DcfManager::AddPassive (DcfState *dcf)
+{
+  NS_LOG_FUNCTION (this << dcf);
+  m_passiveStates.push_back (dcf);
+}
+
 Time
 DcfManager::MostRecent (Time a, Time b) const
 {
@@ -899,6 +906,12 @@ DcfManager::NotifySwitchingStartNow (Time duration)
       state->m_accessRequested = false;
       state->NotifyChannelSwitching ();
     }
+  for (States::iterator i = m_passiveStates.begin (); i != m_passiveStates.end (); i++)
+    {
+      DcfState *state = *i;
+      state->ResetCw ();
+      state->NotifyChannelSwitching ();
+    }
 
   MY_DEBUG ("switching start for " << duration);
   m_lastSwitchingStart = Simulator::Now ();
@@ -923,6 +936,11 @@ DcfManager::NotifySleepNow (void)
       DcfState *state = *i;
       state->NotifySleep ();
     }
+  for (States::iterator i = m_passiveStates.begin (); i != m_passiveStates.end (); i++)
+    {
+      DcfState *state = *i;
+      state->NotifySleep ();
+    }
 }
 
 void
@@ -943,6 +961,12 @@ DcfManager::NotifyWakeupNow (void)
       state->m_accessRequested = false;
       state->NotifyWakeUp ();
     }
+  for (States::iterator i = m_passiveStates.begin (); i != m_passiveStates.end (); i++)
+    {
+      DcfState *state = *i;
+      state->ResetCw ();
+      state->NotifyWakeUp ();
+    }
 }
 
 void
@@ -339,6 +339,16 @@ public:
    * highest priority, etc.
    */
   void Add (DcfState *dcf);
+  /**
+   * \param dcf a DcfState that never requests access.
+   *
+   * Such a DcfState, e.g. the one an OFDMA AP shares between its
+   * per-station queues, whose access is granted by the RRM manager,
+   * takes no part in backoff and access grants. It is only notified of
+   * channel switching, sleep and wake up. The ownership rules of
+   * DcfManager::Add apply.
+   */
+  void AddPassive (DcfState *dcf);
 
   /**
    * \param state a DcfState
@@ -553,6 +563,7 @@ private:
   typedef std::vector<DcfState *> States;
 
   States m_states;
+  States m_passiveStates; //!< DcfStates that never request access
   Time m_lastAckTimeoutEnd;
   Time m_lastCtsTimeoutEnd;
   Time m_lastNavStart;
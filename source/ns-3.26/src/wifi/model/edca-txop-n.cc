@@ -421,6 +421,13 @@ EdcaTxopN::SetTxFailedCallback (TxFailed callback)
   m_txFailedCallback = callback;
 }
 
+void
+EdcaTxopN::SetOfdmaAccessRequestCallback (OfdmaAccessRequest callback)
+{
+  NS_LOG_FUNCTION (this << &callback);
+  m_ofdmaAccessRequestCallback = callback;
+}
+
 void
 EdcaTxopN::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> remoteManager)
 {
@@ -1323,6 +1330,10 @@ EdcaTxopN::RestartAccessIfNeeded (void)
   if (m_isHeCsmaCaActive == false && m_isHeSupported)
     {
       //OFDMA does not require medium access at this point. It will be granted by OFDMA/RRM manager
+      if (!m_ofdmaAccessRequestCallback.IsNull () && NeedsAccess ())
+        {
+          m_ofdmaAccessRequestCallback (m_aid, m_ac);
+        }
       return;
     }
   if ((m_currentPacket != 0
@@ -1363,6 +1374,10 @@ EdcaTxopN::StartAccessIfNeeded (void)
   if (m_isHeCsmaCaActive == false && m_isHeSupported)
     {
       //OFDMA does not require medium access at this point. It will be granted by OFDMA/RRM manager
+      if (!m_ofdmaAccessRequestCallback.IsNull () && NeedsAccess ())
+        {
+          m_ofdmaAccessRequestCallback (m_aid, m_ac);
+        }
       return;
     }
   if (m_currentPacket == 0
@@ -113,6 +113,11 @@ public:
    * packet transmission was failed.
    */
   typedef Callback <void, const WifiMacHeader&> TxFailed;
+  /**
+   * typedef for a callback to invoke when the OFDMA queue of a
+   * station (AID and access category) may need access.
+   */
+  typedef Callback <void, uint16_t, enum AcIndex> OfdmaAccessRequest;
   
   std::map<Mac48Address, bool> m_aMpduEnabled;
 
@@ -144,6 +149,11 @@ public:
    * packet transmission was completed unsuccessfully.
    */
   void SetTxFailedCallback (TxFailed callback);
+  /**
+   * \param callback the callback to invoke, instead of requesting
+   * access to the DcfManager, when this HE queue has data to send.
+   */
+  void SetOfdmaAccessRequestCallback (OfdmaAccessRequest callback);
   /**
    * Set WifiRemoteStationsManager this EdcaTxopN is associated to.
    *
@@ -628,6 +638,7 @@ private:
   Ptr<WifiMacQueue> m_queue;
   TxOk m_txOkCallback;
   TxFailed m_txFailedCallback;
+  OfdmaAccessRequest m_ofdmaAccessRequestCallback;
   Ptr<MacLow> m_low;
   MacTxMiddle *m_txMiddle;
   TransmissionListener *m_transmissionListener;
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/he-bitmap.h"
+#include "he-channel-leakage.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HeChannelLeakage");
+
+/// Integration step of the mask in MHz
+static const double LEAKAGE_STEP = 0.05;
+
+bool
+HeChannelLeakage::Key::operator < (const Key &o) const
+{
+  if (txChannelNumber != o.txChannelNumber)
+    {
+      return txChannelNumber < o.txChannelNumber;
+    }
+  if (txChannelWidth != o.txChannelWidth)
+    {
+      return txChannelWidth < o.txChannelWidth;
+    }
+  if (ru != o.ru)
+    {
+      return ru < o.ru;
+    }
+  if (rxChannelNumber != o.rxChannelNumber)
+    {
+      return rxChannelNumber < o.rxChannelNumber;
+    }
+  return rxChannelWidth < o.rxChannelWidth;
+}
+
+HeChannelLeakage::HeChannelLeakage ()
+{
+}
+
+double
+HeChannelLeakage::GetLeakage (uint16_t txChannelNumber, uint32_t txChannelWidth, uint8_t ru,
+                              uint16_t rxChannelNumber, uint32_t rxChannelWidth)
+{
+  Key key;
+  key.txChannelNumber = txChannelNumber;
+  key.txChannelWidth = txChannelWidth;
+  key.ru = ru;
+  key.rxChannelNumber = rxChannelNumber;
+  key.rxChannelWidth = rxChannelWidth;
+  std::map<Key, double>::const_iterator it = m_leakage.find (key);
+  if (it != m_leakage.end ())
+    {
+      return it->second;
+    }
+
+  const HERuTable &table = HERuTable::Get ();
+  //Number of tones per RU type, see HEBitMap::GetRUInfoFromTriggerBitMap
+  static const uint32_t tones[8] = {0, 26, 52, 106, 242, 484, 996, 1992};
+  RUInfo info = table.GetRUInfo (ru);
+  double occupiedWidth = txChannelWidth;
+  if (info.type > 0 && info.type < 8)
+    {
+      occupiedWidth = std::min (tones[info.type] * 0.078125, occupiedWidth);
+    }
+  double leakage = CalculateLeakage (table.GetCentralFrequency (ru, txChannelNumber) / 1e6, occupiedWidth, txChannelWidth,
+                                     table.GetChannelFrequency (rxChannelNumber) / 1e6, rxChannelWidth);
+  NS_LOG_DEBUG ("channel " << txChannelNumber << " RU " << (uint32_t)ru << " -> channel " << rxChannelNumber <<
+                ": leakage=" << 10 * std::log10 (leakage) << "dB");
+  m_leakage[key] = leakage;
+  return leakage;
+}
+
+double
+HeChannelLeakage::GetMask (double offset, double occupiedWidth, double channelWidth)
+{
+  //Distance from the edge of the occupied band
+  double d = std::abs (offset) - occupiedWidth / 2;
+  //Breakpoints of the mask: distance from the edge and level in dBr
+  const double x[4] = {0, 0.5, channelWidth / 2, channelWidth};
+  const double dbr[4] = {0, -20, -28, -40};
+  if (d <= 0)
+    {
+      return 1;
+    }
+  for (uint32_t i = 1; i < 4; i++)
+    {
+      if (d <= x[i])
+        {
+          double level = dbr[i - 1] + (dbr[i] - dbr[i - 1]) * (d - x[i - 1]) / (x[i] - x[i - 1]);
+          return std::pow (10.0, level / 10.0);
+        }
+    }
+  return 0;
+}
+
+double
+HeChannelLeakage::CalculateLeakage (double txCenter, double occupiedWidth, double channelWidth,
+                                    double rxCenter, double rxWidth)
+{
+  //Integrate the mask over the part of the channel of the receiver it covers
+  double extent = occupiedWidth / 2 + channelWidth;
+  double low = std::max (rxCenter - rxWidth / 2, txCenter - extent);
+  double high = std::min (rxCenter + rxWidth / 2, txCenter + extent);
+  if (low >= high)
+    {
+      return 0;
+    }
+  uint32_t n = static_cast<uint32_t> (std::ceil ((high - low) / LEAKAGE_STEP));
+  double step = (high - low) / n;
+  double sum = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += GetMask (low + (i + 0.5) * step - txCenter, occupiedWidth, channelWidth);
+    }
+  return sum * step / occupiedWidth;
+}
+
+} //namespace ns3
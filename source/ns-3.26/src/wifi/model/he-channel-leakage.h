@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HE_CHANNEL_LEAKAGE_H
+#define HE_CHANNEL_LEAKAGE_H
+
+#include <map>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief power leaked by a HE transmission into the channel of another PHY
+ * \ingroup wifi
+ *
+ * The transmitted power is spread according to a transmit spectral mask
+ * shaped after the one of 802.11ax: 0 dBr over the occupied band, i.e.
+ * the RU or the whole channel, then -20 dBr 0.5 MHz beyond its edges,
+ * -28 dBr half a channel width beyond and -40 dBr one channel width
+ * beyond, with linear interpolation in dB. The mask is truncated there.
+ * The leakage is the part of the masked power that falls in the channel
+ * of the receiver, relative to the power in the occupied band.
+ *
+ * Channel centres and RU offsets come from HERuTable. The leakage is
+ * integrated once per (channel, width, RU, channel, width) combination
+ * and kept in a table.
+ */
+class HeChannelLeakage
+{
+public:
+  HeChannelLeakage ();
+
+  /**
+   * \param txChannelNumber the channel number of the transmitter
+   * \param txChannelWidth the channel width of the transmitter in MHz
+   * \param ru the RU bitmap of the transmission, 0xff for the whole channel
+   * \param rxChannelNumber the channel number of the receiver
+   * \param rxChannelWidth the channel width of the receiver in MHz
+   *
+   * \return the leaked power relative to the transmitted power (linear),
+   *         0 if the channel of the receiver is beyond the mask
+   */
+  double GetLeakage (uint16_t txChannelNumber, uint32_t txChannelWidth, uint8_t ru,
+                     uint16_t rxChannelNumber, uint32_t rxChannelWidth);
+  /**
+   * \param txCenter the centre of the occupied band in MHz
+   * \param occupiedWidth the width of the occupied band in MHz
+   * \param channelWidth the channel width of the transmitter in MHz,
+   *        which sets the extent of the mask
+   * \param rxCenter the centre of the channel of the receiver in MHz
+   * \param rxWidth the channel width of the receiver in MHz
+   *
+   * \return the part of the masked power in the channel of the receiver,
+   *         relative to the power in the occupied band (linear)
+   */
+  static double CalculateLeakage (double txCenter, double occupiedWidth, double channelWidth,
+                                  double rxCenter, double rxWidth);
+
+private:
+  /**
+   * \param offset the distance from the centre of the occupied band in MHz
+   * \param occupiedWidth the width of the occupied band in MHz
+   * \param channelWidth the channel width of the transmitter in MHz
+   *
+   * \return the mask relative to the occupied band (linear), 0 beyond
+   *         the mask
+   */
+  static double GetMask (double offset, double occupiedWidth, double channelWidth);
+
+  /// Key of the leakage table
+  struct Key
+  {
+    uint16_t txChannelNumber; //!< channel number of the transmitter
+    uint32_t txChannelWidth;  //!< channel width of the transmitter
+    uint8_t ru;               //!< RU bitmap
+    uint16_t rxChannelNumber; //!< channel number of the receiver
+    uint32_t rxChannelWidth;  //!< channel width of the receiver
+
+    bool operator < (const Key &o) const;
+  };
+
+  std::map<Key, double> m_leakage; //!< leakage per combination met so far
+};
+
+} //namespace ns3
+
+#endif /* HE_CHANNEL_LEAKAGE_H */
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This file is for OFDMA/802.11ax type of systems. It is not
+ * fully compliant to IEEE 802.11ax standards.
+ */
+
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "he-link-abstraction.h"
+#include "table-error-rate-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HELinkAbstraction");
+
+NS_OBJECT_ENSURE_REGISTERED (HELinkAbstraction);
+
+TypeId
+HELinkAbstraction::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HELinkAbstraction")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<HELinkAbstraction> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model the PER is obtained from. If not set, each link "
+                   "abstraction creates its own TableErrorRateModel at its first query, with "
+                   "the default attribute values of TableErrorRateModel at that time.",
+                   PointerValue (),
+                   MakePointerAccessor (&HELinkAbstraction::m_errorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+  ;
+  return tid;
+}
+
+HELinkAbstraction::HELinkAbstraction ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HELinkAbstraction::~HELinkAbstraction ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HELinkAbstraction::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_errorRateModel = 0;
+}
+
+double
+HELinkAbstraction::GetPer (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits)
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits);
+  if (m_errorRateModel == 0)
+    {
+      m_errorRateModel = CreateObject<TableErrorRateModel> ();
+    }
+  return 1 - m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+} //namespace ns3
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This file is for OFDMA/802.11ax type of systems. It is not
+ * fully compliant to IEEE 802.11ax standards.
+ */
+
+#ifndef HE_LINK_ABSTRACTION_H
+#define HE_LINK_ABSTRACTION_H
+
+#include <stdint.h>
+#include "ns3/object.h"
+#include "wifi-mode.h"
+#include "wifi-tx-vector.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief link to system abstraction of the HE PHY
+ * \ingroup wifi
+ *
+ * An HEWifiPhy with a link abstraction does not evaluate the error rate
+ * of each chunk of a PPDU with constant SINR: it maps the effective SINR
+ * of the payload on its RU to a PER through a single error rate model
+ * query. The default model is a TableErrorRateModel of its own, which
+ * makes this query a table lookup.
+ */
+class HELinkAbstraction : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  HELinkAbstraction ();
+  virtual ~HELinkAbstraction ();
+
+  /**
+   * \param mode the mode of the payload
+   * \param txVector the TXVECTOR of the PPDU
+   * \param snr the effective SINR (linear)
+   * \param nbits the number of bits of the payload
+   *
+   * \return the packet error rate
+   */
+  double GetPer (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  Ptr<ErrorRateModel> m_errorRateModel; //!< Model the PER is obtained from
+};
+
+} //namespace ns3
+
+#endif /* HE_LINK_ABSTRACTION_H */
@@ -35,6 +35,8 @@
 #include "interference-helper.h"
 #include "wifi-phy.h"
 #include "error-rate-model.h"
+#include "he-link-abstraction.h"
+#include "wifi-profiler.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <algorithm>
@@ -136,7 +138,7 @@ InterferenceHelper::NiChange::GetDelta (void) const
   return m_delta;
 }
 
-double
+uint8_t
 InterferenceHelper::NiChange::GetRu (void) const
 {
   return m_ru;
@@ -171,6 +173,7 @@ InterferenceHelper::Add (uint32_t size, WifiTxVector txVector,
                          enum WifiPreamble preamble,
                          Time duration, double rxPowerW)
 {
+  WifiProfiler::Scope scope (WifiProfiler::INTERFERENCE_HELPER);
   Ptr<InterferenceHelper::Event> event;
 
   event = Create<InterferenceHelper::Event> (size,
@@ -218,11 +221,12 @@ InterferenceHelper::GetErrorRateModel (void) const
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
+  WifiProfiler::Scope scope (WifiProfiler::INTERFERENCE_HELPER);
   Time now = Simulator::Now ();
   double noiseInterferenceW = 0.0;
   Time end = now;
   noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChangeSet::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
@@ -244,21 +248,17 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
       //Disable floor noise for now.
 #if 0
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
+      NiChangeSet::iterator nowIterator = m_niChanges.upper_bound (NiChange (now, 0, 0));
+      for (NiChangeSet::iterator i = m_niChanges.begin (); i != nowIterator; i++)
         {
           m_firstPower += i->GetDelta ();
         }
 #endif
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW (), event->GetTxVector().GetRu()));
-    }
-  else
-    {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW (), event->GetTxVector().GetRu()));
+      EraseNiChangesUntil (now);
     }
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW (), event->GetTxVector().GetRu()));
   AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW (), event->GetTxVector().GetRu()));
 }
 
@@ -283,25 +283,29 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event>
 {
   double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  uint8_t ru = event->GetTxVector().GetRu();
+  // noise is considered only for the same RU events as that of current event,
+  // and for the whole channel events
+  static const NiChangeSet empty;
+  NiChangesPerRu::const_iterator channel = m_niChangesPerRu.find (0xff);
+  NiChangesPerRu::const_iterator sameRu = ru == 0xff ? m_niChangesPerRu.end () : m_niChangesPerRu.find (ru);
+  const NiChangeSet &a = channel == m_niChangesPerRu.end () ? empty : channel->second;
+  const NiChangeSet &b = sameRu == m_niChangesPerRu.end () ? empty : sameRu->second;
+  //Consider only those events which occured after rxing started on the RU
+  NiChange start (event->GetStartTime (), 0, ru);
+  NiChangeSet::const_iterator i = a.upper_bound (start);
+  NiChangeSet::const_iterator j = b.upper_bound (start);
+  while (i != a.end () || j != b.end ())
     {
-      if (i->GetTime () <= event->GetStartTime () )
-	{
-	  //Consider only those events which occured after rxing started on the RU
-	  continue;
-	}
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
+      const NiChange &change = (j == b.end () || (i != a.end () && !(*j < *i))) ? *i++ : *j++;
+      if ((event->GetEndTime () == change.GetTime ()) && event->GetRxPowerW () == -change.GetDelta ())
         {
           break;
         }
-      if (i->GetRu() == 0xff || event->GetTxVector().GetRu() == i->GetRu())
-	{
-	  // noise is considered only for the same RU events as that of current event
-	  ni->push_back (*i);
-	}
+      ni->push_back (change);
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference, event->GetTxVector().GetRu()));
-  ni->push_back (NiChange (event->GetEndTime (), 0, event->GetTxVector().GetRu()));
+  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference, ru));
+  ni->push_back (NiChange (event->GetEndTime (), 0, ru));
   return noiseInterference;
 }
 
@@ -827,6 +831,7 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
+  WifiProfiler::Scope scope (WifiProfiler::INTERFERENCE_HELPER);
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
@@ -847,6 +852,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event)
 {
+  WifiProfiler::Scope scope (WifiProfiler::INTERFERENCE_HELPER);
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
@@ -864,24 +870,83 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
   return snrPer;
 }
 
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateEffectiveSnrPer (Ptr<InterferenceHelper::Event> event,
+                                              Ptr<HELinkAbstraction> abstraction)
+{
+  WifiProfiler::Scope scope (WifiProfiler::INTERFERENCE_HELPER);
+  NiChanges ni;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  uint32_t channelWidth = event->GetTxVector ().GetChannelWidth ();
+  double snr = CalculateSnr (event->GetRxPowerW (), noiseInterferenceW, channelWidth);
+
+  WifiPreamble preamble = event->GetPreambleType ();
+  Time plcpHeaderStart = event->GetStartTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector (), preamble); //packet start time + preamble
+  Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (event->GetTxVector (), preamble); //packet start time + preamble + L-SIG
+  Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpVhtSigA1Duration (preamble) + WifiPhy::GetPlcpVhtSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2)
+  Time plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble, event->GetTxVector ()) + WifiPhy::GetPlcpVhtSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2) + (V)HT Training + VHT-SIG-B
+  Time plcpPayloadEnd = event->GetEndTime ();
+  double energyJ = 0;
+  Time previous = ni.front ().GetTime ();
+  double powerW = ni.front ().GetDelta ();
+  for (NiChanges::const_iterator j = ni.begin () + 1; j != ni.end (); j++)
+    {
+      Time from = std::max (previous, plcpPayloadStart);
+      Time to = std::min (j->GetTime (), plcpPayloadEnd);
+      if (to > from)
+        {
+          energyJ += powerW * (to - from).GetSeconds ();
+        }
+      powerW += j->GetDelta ();
+      previous = j->GetTime ();
+    }
+  double meanNoiseInterferenceW = noiseInterferenceW;
+  if (plcpPayloadEnd > plcpPayloadStart)
+    {
+      meanNoiseInterferenceW = energyJ / (plcpPayloadEnd - plcpPayloadStart).GetSeconds ();
+    }
+  double effectiveSnr = CalculateSnr (event->GetRxPowerW (), meanNoiseInterferenceW, channelWidth);
+
+  struct SnrPer snrPer;
+  snrPer.snr = snr;
+  snrPer.per = abstraction->GetPer (event->GetPayloadMode (), event->GetTxVector (),
+                                    effectiveSnr, event->GetSize () * 8);
+  return snrPer;
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
   m_niChanges.clear ();
+  m_niChangesPerRu.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
+void
+InterferenceHelper::EraseNiChangesUntil (Time moment)
 {
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0, 0));
+  NiChange limit (moment, 0, 0);
+  m_niChanges.erase (m_niChanges.begin (), m_niChanges.upper_bound (limit));
+  for (NiChangesPerRu::iterator i = m_niChangesPerRu.begin (); i != m_niChangesPerRu.end (); )
+    {
+      i->second.erase (i->second.begin (), i->second.upper_bound (limit));
+      if (i->second.empty ())
+        {
+          m_niChangesPerRu.erase (i++);
+        }
+      else
+        {
+          i++;
+        }
+    }
 }
 
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  m_niChanges.insert (change);
+  m_niChangesPerRu[change.GetRu ()].insert (change);
 }
 
 void
@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <set>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -47,6 +49,8 @@
 
 namespace ns3 {
 
+class HELinkAbstraction;
+
 /**
  * \ingroup wifi
  * \brief handles interference calculations
@@ -219,6 +223,18 @@ private:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event);
+  /**
+   * Calculate the SNIR at the start of the plcp payload, and the PER of
+   * the payload from its effective SNIR, i.e. the ratio of the signal
+   * power to the mean noise and interference power over the payload.
+   *
+   * \param event the event corresponding to the first time the corresponding packet arrives
+   * \param abstraction the link abstraction mapping the effective SNIR to a PER
+   *
+   * \return struct of SNR and PER
+   */
+  struct InterferenceHelper::SnrPer CalculateEffectiveSnrPer (Ptr<InterferenceHelper::Event> event,
+                                                              Ptr<HELinkAbstraction> abstraction);
 
   /**
    * Notify that RX has started.
@@ -261,11 +277,11 @@ public:
      */
     double GetDelta (void) const;
     /**
-     * Return the power
+     * Return the RU, 0xff for the whole channel
      *
-     * \return the power
+     * \return the RU
      */
-    double GetRu (void) const;
+    uint8_t GetRu (void) const;
     /**
      * Compare the event time of two NiChange objects (a < o).
      *
@@ -284,6 +300,15 @@ private:
    * typedef for a vector of NiChanges
    */
   typedef std::vector <NiChange> NiChanges;
+  /**
+   * typedef for a time-ordered set of NiChanges. Changes with the same
+   * time are kept in insertion order.
+   */
+  typedef std::multiset <NiChange> NiChangeSet;
+  /**
+   * typedef for the NiChanges of each RU, 0xff being the whole channel
+   */
+  typedef std::map <uint8_t, NiChangeSet> NiChangesPerRu;
   /**
    * typedef for a list of Events
    */
@@ -352,13 +377,19 @@ private:
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
   /// Experimental: needed for energy duration calculation
-  NiChanges m_niChanges;
+  NiChangeSet m_niChanges;
+  /// The same changes, partitioned per RU for the SNR calculations
+  NiChangesPerRu m_niChangesPerRu;
   double m_firstPower;
   bool m_rxing;
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Erase all changes up to the given time.
+   *
+   * \param moment
+   */
+  void EraseNiChangesUntil (Time moment);
+  /**
+   * Add NiChange to the list and to the list of its RU.
    *
    * \param change
    */
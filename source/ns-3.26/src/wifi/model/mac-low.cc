@@ -51,6 +51,8 @@
 #include "ampdu-tag.h"
 #include "wifi-mac-queue.h"
 #include "ns3/he-bitmap.h"
+#include "wifi-profiler.h"
+#include <algorithm>
 
 #undef NS_LOG_APPEND_CONTEXT
 #define NS_LOG_APPEND_CONTEXT std::clog << "[mac=" << m_self << "] "
@@ -535,6 +537,9 @@ MacLow::DoDispose (void)
     }
   m_sentMpdus = 0;
   m_aggregateQueue = 0;
+  m_heStations.clear ();
+  m_heAggQueues.clear ();
+  m_freeHeAggQueues.clear ();
   m_ampdu = false;
 }
 
@@ -836,7 +841,7 @@ MacLow::SetOfdmaHeTransmit (bool enable)
   NS_LOG_FUNCTION(this);
   m_currentSI =  Seconds(0);
   m_isHeMuMpduStarted = enable;
-  m_heStations.clear ();
+  ReleaseHeAggQueues (m_heStations);
 }
 
 void
@@ -845,6 +850,7 @@ MacLow::EnqueueToHeMpduList (Ptr<const Packet> packet,
 			     MacLowTransmissionParameters params,
 			     MacLowTransmissionListener *listener)
 {
+  WifiProfiler::Scope scope (WifiProfiler::ENQUEUE_TO_HE_MPDU_LIST);
   /**
    * HE packets follow a different approach Trigger/MURTS-DATA-ACK and
    * the data may be destined to more than one clients at the same time
@@ -854,19 +860,15 @@ MacLow::EnqueueToHeMpduList (Ptr<const Packet> packet,
   HeMpduItem item;
   item.hdr = *hdr;
   item.listener = listener;
-  item.packet = packet->Copy();
-  SocketPriorityTag priorityTag;
-  item.packet->RemovePacketTag (priorityTag);
   item.params = params;
-  item.txVector = GetDataTxVector(item.packet, &item.hdr);
+  item.txVector = GetDataTxVector(packet, &item.hdr);
 
   //Perform MPDU aggregation if possible
   uint32_t size, actualSize;
   WifiMacTrailer fcs;
   size = packet->GetSize () + hdr->GetSize () + fcs.GetSerializedSize ();
-  item.aggQueue = CreateObject<WifiMacQueue> ();
+  AcquireHeAggQueue (item);
   Ptr<Packet> p = AggregateToAmpdu (packet, *hdr, item.aggQueue);
-  //Ptr<Packet> p = packet->Copy();
   actualSize = p->GetSize ();
   if (actualSize > size)
     {
@@ -886,9 +888,52 @@ MacLow::EnqueueToHeMpduList (Ptr<const Packet> packet,
     }
   else
     {
+      //Only the plain MPDU needs a private copy without the priority tag
+      item.packet = packet->Copy();
+      SocketPriorityTag priorityTag;
+      item.packet->RemovePacketTag (priorityTag);
       item.isAmpdu = false;
     }
-  m_heStations.insert(std::make_pair(hdr->GetAddr1(),item));
+  if (!m_heStations.insert(std::make_pair(hdr->GetAddr1(),item)).second)
+    {
+      ReleaseHeAggQueue (item);
+    }
+}
+
+void
+MacLow::AcquireHeAggQueue (HeMpduItem &item)
+{
+  if (m_freeHeAggQueues.empty ())
+    {
+      item.aggQueueSlot = m_heAggQueues.size ();
+      m_heAggQueues.push_back (CreateObject<WifiMacQueue> ());
+    }
+  else
+    {
+      item.aggQueueSlot = m_freeHeAggQueues.back ();
+      m_freeHeAggQueues.pop_back ();
+    }
+  item.aggQueue = m_heAggQueues[item.aggQueueSlot];
+  item.aggQueue->Flush ();
+}
+
+void
+MacLow::ReleaseHeAggQueue (HeMpduItem &item)
+{
+  NS_ASSERT (item.aggQueueSlot < m_heAggQueues.size ());
+  NS_ASSERT (std::find (m_freeHeAggQueues.begin (), m_freeHeAggQueues.end (), item.aggQueueSlot) == m_freeHeAggQueues.end ());
+  m_freeHeAggQueues.push_back (item.aggQueueSlot);
+  item.aggQueue = 0;
+}
+
+void
+MacLow::ReleaseHeAggQueues (HEStations &stations)
+{
+  for (HEStationsI it = stations.begin (); it != stations.end (); it++)
+    {
+      ReleaseHeAggQueue (it->second);
+    }
+  stations.clear ();
 }
 
 void
@@ -1021,18 +1066,7 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
 
       if (padDuration > Seconds(0.0))
 	{
-	  if(m_ampdu)
-	    {
-	      WifiMacHeader hdr;
-	      Ptr<Packet> newPacket = m_aggregateQueue->Dequeue(&hdr)->Copy ();
-	      newPacket->AddPaddingAtEnd (padSize);
-	      m_aggregateQueue->PushFront(newPacket, hdr);
-	      m_currentPacket->AddPaddingAtEnd(padSize);
-	    }
-	  else
-	    {
-	      m_currentPacket->AddPaddingAtEnd(padSize);
-	    }
+	  m_currentTxVector.SetPadding (padSize);
 	}
     }
     
@@ -1174,9 +1208,7 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, Wifi
 		  for (staRuMap::const_iterator j = ruMapGetInfo.begin (); j != ruMapGetInfo.end (); j ++)
 		  {
                       if(j->second.m_aid == GetAid()) {
-                          HEBitMap BitMap;
-
-                          ruInfoRx = BitMap.GetRUInfoFromTriggerBitMap(j->second.index);
+                          ruInfoRx = HERuTable::Get ().GetRUInfo (j->second.index);
 
 		          NS_LOG_DEBUG ("rx RTS from=" << hdr.GetAddr2 () << ", schedule CTS");
 			  NS_ASSERT (m_sendCtsEvent.IsExpired ());
@@ -2328,8 +2360,7 @@ MacLow::GetMaxDurationForBsr (staRuMap staMap, WifiTxVector bsrpTxVector)
 
   for (staRuMap::const_iterator j = staMap.begin (); j != staMap.end (); j ++)
   {
-      HEBitMap bitmap;
-      RUInfo ruI = bitmap.GetRUInfoFromTriggerBitMap(j->second.index);
+      RUInfo ruI = HERuTable::Get ().GetRUInfo (j->second.index);
       uint32_t chanW = 20;
       if (ruI.type == 1)
         chanW = 2;
@@ -2380,47 +2411,60 @@ MacLow::GetMaxDurationForAck ()
 Time
 MacLow::GetMaxDurationForSI (void)
 {
-  Time              txDuration = Seconds(0);
   Time              maxDuration = Seconds(0);
+  std::vector<Time> durations;
 
-  for(HEStationsI s = m_heStations.begin(); s != m_heStations.end(); s++)
+  GetHeMpduTxDurations (durations);
+  for (std::vector<Time>::const_iterator d = durations.begin (); d != durations.end (); d++)
   {
-      HeMpduItem item = s->second;
-      if (item.isAmpdu)
-	{
-	  txDuration = m_phy->CalculateTxDuration (item.packet->GetSize (), item.txVector, WIFI_PREAMBLE_HE, m_phy->GetFrequency ());
-	}
-      else
-	{
-	  txDuration = m_phy->CalculateTxDuration (item.packet->GetSize () + item.hdr.GetSize()+4, item.txVector, WIFI_PREAMBLE_HE, m_phy->GetFrequency ());
-	}
-      if(txDuration > maxDuration) {
-          maxDuration = txDuration;
+      if(*d > maxDuration) {
+          maxDuration = *d;
       }
   }
   return maxDuration;
 }
 
 void
-MacLow::PadHeMpduIfNeeded (Time duration)
+MacLow::GetHeMpduTxDurations (std::vector<Time> &durations)
 {
-  Time              txDuration;
-  Time              maxDuration;
-  Time              padDuration;
-  uint32_t          padSize;
+  std::vector<uint32_t>     sizes;
+  std::vector<WifiTxVector> txVectors;
 
+  sizes.reserve (m_heStations.size ());
+  txVectors.reserve (m_heStations.size ());
   for(HEStationsI s = m_heStations.begin(); s != m_heStations.end(); s++)
     {
-      HeMpduItem item = s->second;
+      const HeMpduItem &item = s->second;
       if (item.isAmpdu)
 	{
-	  txDuration = m_phy->CalculateTxDuration (item.packet->GetSize (), item.txVector, WIFI_PREAMBLE_HE, m_phy->GetFrequency ());
+	  sizes.push_back (item.packet->GetSize ());
 	}
       else
 	{
-	  txDuration = m_phy->CalculateTxDuration (item.packet->GetSize () + item.hdr.GetSize() + 4, item.txVector, WIFI_PREAMBLE_HE, m_phy->GetFrequency ());
+	  sizes.push_back (item.packet->GetSize () + item.hdr.GetSize() + 4);
 	}
-      padDuration = duration - txDuration;
+      txVectors.push_back (item.txVector);
+    }
+  m_phy->CalculateTxDurations (sizes, txVectors, WIFI_PREAMBLE_HE, m_phy->GetFrequency (), durations);
+}
+
+void
+MacLow::PadHeMpduIfNeeded (Time duration)
+{
+  Time              padDuration;
+  uint32_t          padSize;
+  std::vector<Time> durations;
+
+  for(HEStationsI s = m_heStations.begin(); s != m_heStations.end(); s++)
+    {
+      s->second.txVector.SetPadding (0);
+    }
+  GetHeMpduTxDurations (durations);
+  std::vector<Time>::const_iterator txDuration = durations.begin ();
+  for(HEStationsI s = m_heStations.begin(); s != m_heStations.end(); s++, txDuration++)
+    {
+      HeMpduItem &item = s->second;
+      padDuration = duration - *txDuration;
 
       double seconds = padDuration.GetSeconds();
       double dataRate = item.txVector.GetMode ().GetDataRate (item.txVector);
@@ -2433,17 +2477,10 @@ MacLow::PadHeMpduIfNeeded (Time duration)
 	}
       if(item.isAmpdu)
 	{
-	  WifiMacHeader hdr;
-	  Ptr<Packet> newPacket = item.aggQueue->Dequeue(&hdr)->Copy ();
 	  padSize += (4 - (padSize % 4 )) % 4;
-          newPacket->AddPaddingAtEnd (padSize);
-          item.aggQueue->PushFront(newPacket, hdr);
-	  item.packet->AddPaddingAtEnd(padSize);
-	}
-      else
-	{
-	  item.packet->AddPaddingAtEnd(padSize);
 	}
+      //The padding only lengthens the PSDU on air, see WifiTxVector::SetPadding
+      item.txVector.SetPadding (padSize);
     }
 }
 
@@ -2591,6 +2628,7 @@ void
 MacLow::SendBasicTrigger(staRuMap staMap, Time uplinkDuration)
 {
   NS_LOG_FUNCTION (this);
+  WifiProfiler::Scope scope (WifiProfiler::SEND_BASIC_TRIGGER);
   /* send an Basic Trigger for this packet. */
   WifiMacHeader macHdr;
   WifiHeTriggerMacHeader trgHdr;
@@ -2650,8 +2688,7 @@ MacLow::IsFirstHeMuMpdu(WifiMacHeader hdr)
 void
 MacLow::SetChannelWidthForRu(WifiTxVector &txVector)
 {
-  HEBitMap bitmap;
-  RUInfo ruI = bitmap.GetRUInfoFromTriggerBitMap(txVector.GetRu());
+  RUInfo ruI = HERuTable::Get ().GetRUInfo (txVector.GetRu());
   uint32_t chanW = 20;
   if (ruI.type == 1)
     chanW = 2;
@@ -2707,8 +2744,8 @@ void
 MacLow::StartNextHeMuMpdu (void)
 {
   NS_LOG_FUNCTION (this);
-  HEStations        m_heStationsCopy = m_heStations;
-  m_heStations.clear();
+  HEStations        m_heStationsCopy;
+  m_heStationsCopy.swap (m_heStations);
   for(HEStationsI it=m_heStationsCopy.begin(); it != m_heStationsCopy.end(); it++)
     {
       HeMpduItem item = it->second;
@@ -2723,6 +2760,7 @@ MacLow::StartNextHeMuMpdu (void)
          item.listener->StartNext();
        }
     }
+  ReleaseHeAggQueues (m_heStationsCopy);
   if (!m_heStations.empty())
     {
       // Lets begin next round
@@ -2764,6 +2802,7 @@ MacLow::SendHeMuMpdu (Time duration)
 	  item.listener->MissedCts();
 	  HEStationsI it1 = it;
 	  it1++;
+	  ReleaseHeAggQueue (it->second);
 	  m_heStations.erase(it);
 	  it = it1;
 	}
@@ -3777,10 +3816,18 @@ MacLow::StoreMpduIfNeeded (Ptr<Packet> packet, WifiMacHeader hdr)
       uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
       uint16_t mappedSeqControl = QosUtilsMapSeqControlToUniqueInteger (hdr.GetSequenceControl (), endSequence);
 
-      BufferedPacketI i = (*it).second.second.begin ();
-      for (; i != (*it).second.second.end ()
-           && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedSeqControl; i++)
+      //MPDUs are mostly received in order, so look for the insertion point
+      //from the back of the reordering buffer
+      BufferedPacketI i = (*it).second.second.end ();
+      while (i != (*it).second.second.begin ())
         {
+          BufferedPacketI prev = i;
+          prev--;
+          if (QosUtilsMapSeqControlToUniqueInteger ((*prev).second.GetSequenceControl (), endSequence) < mappedSeqControl)
+            {
+              break;
+            }
+          i = prev;
         }
       (*it).second.second.insert (i, bufferedPacket);
 
@@ -1425,6 +1425,11 @@ private:
   WifiTxVector GetBlockAckTxVector (WifiTxVector dataTxVector) const;
 
   void PadHeMpduIfNeeded (Time duration);
+  /**
+   * \param durations the transmission duration of each staged HE MU MPDU,
+   *        in the order of m_heStations
+   */
+  void GetHeMpduTxDurations (std::vector<Time> &durations);
 
   Ptr<WifiPhy> m_phy; //!< Pointer to WifiPhy (actually send/receives frames)
   Ptr<WifiRemoteStationManager> m_stationManager; //!< Pointer to WifiRemoteStationManager (rate control)
@@ -1527,6 +1532,7 @@ private:
     MacLowTransmissionParameters params;
     WifiTxVector                 txVector;
     Ptr<WifiMacQueue>            aggQueue;
+    uint32_t                     aggQueueSlot; //!< slot of aggQueue in the pool
     bool                         isAmpdu;
     Time                         ctsDurationDiff;
   } HeMpduItem;
@@ -1534,6 +1540,28 @@ private:
   typedef std::map<Mac48Address, HeMpduItem> HEStations;
   typedef std::map<Mac48Address, HeMpduItem>::iterator HEStationsI;
 
+  /**
+   * Give an HE MU MPDU item an empty aggregation queue and its pool slot,
+   * reusing a released slot if possible.
+   *
+   * \param item the HE MU MPDU item
+   */
+  void AcquireHeAggQueue (HeMpduItem &item);
+  /**
+   * Return the pool slot of an HE MU MPDU item. The item must not use its
+   * aggregation queue afterwards.
+   *
+   * \param item the HE MU MPDU item
+   */
+  void ReleaseHeAggQueue (HeMpduItem &item);
+  /**
+   * Return the aggregation queues of the given items to the pool and
+   * clear them.
+   *
+   * \param stations the HE MU MPDU items
+   */
+  void ReleaseHeAggQueues (HEStations &stations);
+
 
   Agreements m_bAckAgreements;
   BlockAckCaches m_bAckCaches;
@@ -1549,6 +1577,8 @@ private:
   std::vector<Item> m_txPackets;      //!< Contain temporary items to be sent with the next A-MPDU transmission, once RTS/CTS exchange has succeeded. It is not used in other cases.
   uint32_t m_nTxMpdus;                //!<Holds the number of transmitted MPDUs in the last A-MPDU transmission
   HEStations        m_heStations;
+  std::vector<Ptr<WifiMacQueue> > m_heAggQueues; //!< HE aggregation queues, per pool slot
+  std::vector<uint32_t> m_freeHeAggQueues;        //!< pool slots not held by an HE MU MPDU item
   bool              m_isHeMuMpduStarted;
   bool              m_isHeMuTbMpduStarted;
   Time              m_tbMpduDuration;
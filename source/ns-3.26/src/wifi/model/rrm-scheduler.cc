@@ -0,0 +1,423 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This file is for OFDMA/802.11ax type of systems. It is not
+ * fully compliant to IEEE 802.11ax standards.
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "rrm-scheduler.h"
+#include "qos-utils.h"
+#include <cstring>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RRMScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (RRMScheduler);
+NS_OBJECT_ENSURE_REGISTERED (RoundRobinRRMScheduler);
+NS_OBJECT_ENSURE_REGISTERED (UtilityRRMScheduler);
+
+TypeId
+RRMScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RRMScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+RRMScheduler::RRMScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RRMScheduler::~RRMScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+int
+RRMScheduler::SelectAccessCategory (const int depth[4])
+{
+  static const int priority[] = {AC_VO, AC_VI, AC_BE, AC_BK};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      if (depth[priority[i]] > 0)
+        {
+          return priority[i];
+        }
+    }
+  return -1;
+}
+
+TypeId
+RoundRobinRRMScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RoundRobinRRMScheduler")
+    .SetParent<RRMScheduler> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<RoundRobinRRMScheduler> ()
+    .AddAttribute ("StationsPerRound",
+                   "The maximum number of stations served in one round.",
+                   UintegerValue (9),
+                   MakeUintegerAccessor (&RoundRobinRRMScheduler::m_stationsPerRound),
+                   MakeUintegerChecker<uint32_t> (1, 9))
+  ;
+  return tid;
+}
+
+RoundRobinRRMScheduler::RoundRobinRRMScheduler ()
+  : m_lastServedDl (0),
+    m_lastServedUl (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_ruTable = CreateObject<HEBitMap> ();
+}
+
+RoundRobinRRMScheduler::~RoundRobinRRMScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RoundRobinRRMScheduler::Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                                  std::vector<RRMClientResponse_t> &results)
+{
+  NS_LOG_FUNCTION (this << isDownlink << stats.size ());
+  uint32_t nStations = stats.size ();
+  uint32_t &lastServed = isDownlink ? m_lastServedDl : m_lastServedUl;
+  uint32_t start = lastServed;
+  struct RUInfo ruI = {1, 0};
+
+  results.clear ();
+  if (nStations == 0)
+    {
+      return;
+    }
+  //Each station is visited at most once per round
+  for (uint32_t n = 1; n <= nStations && results.size () < m_stationsPerRound; n++)
+    {
+      uint32_t i = (start + n) % nStations;
+      int ac;
+      //The statistics are packed, copy the depths to aligned storage
+      int depth[4];
+      if (isDownlink)
+        {
+          memcpy (depth, stats[i].bufferDepthDL, sizeof (depth));
+          ac = SelectAccessCategory (depth);
+          if (ac < 0)
+            {
+              continue;
+            }
+        }
+      else
+        {
+          //Stations without a valid BSR are polled on best effort
+          memcpy (depth, stats[i].bufferDepthUL, sizeof (depth));
+          ac = SelectAccessCategory (depth);
+          if (ac < 0)
+            {
+              ac = AC_BE;
+            }
+        }
+      RRMClientResponse_t resp;
+      memset (&resp, 0, sizeof (resp));
+      memcpy (resp.macStr, stats[i].macStr, MAC_ADDR_LEN);
+      resp.trafficType = ac;
+      resp.ruBitMap = m_ruTable->GetBitMapFromRUInfo (ruI);
+      resp.mcsValue = stats[i].mcsVal;
+      resp.chanW = 2;
+      results.push_back (resp);
+      ruI.index++;
+      lastServed = i;
+    }
+}
+
+TypeId
+UtilityRRMScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::UtilityRRMScheduler")
+    .SetParent<RRMScheduler> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<UtilityRRMScheduler> ()
+    .AddAttribute ("Utility",
+                   "The utility maximized in each round.",
+                   EnumValue (UtilityRRMScheduler::PROPORTIONAL_FAIR),
+                   MakeEnumAccessor (&UtilityRRMScheduler::m_utility),
+                   MakeEnumChecker (UtilityRRMScheduler::MAX_RATE, "MaxRate",
+                                    UtilityRRMScheduler::PROPORTIONAL_FAIR, "ProportionalFair",
+                                    UtilityRRMScheduler::DELAY_WEIGHTED, "DelayWeighted"))
+    .AddAttribute ("AveragingRounds",
+                   "The number of rounds over which the served rate of a station is averaged "
+                   "(ProportionalFair and DelayWeighted utilities).",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&UtilityRRMScheduler::m_averagingRounds),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("DelayScale",
+                   "The waiting time in ms that doubles the weight of VO and VI traffic "
+                   "(DelayWeighted utility).",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&UtilityRRMScheduler::m_delayScale),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+UtilityRRMScheduler::UtilityRRMScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  m_ruTable = CreateObject<HEBitMap> ();
+  BuildTables ();
+}
+
+UtilityRRMScheduler::~UtilityRRMScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+UtilityRRMScheduler::BuildTables (void)
+{
+  //Channel width (in the units of RRMClientResponse_t::chanW) per RU type
+  static const uint32_t chanW[] = {0, 2, 4, 8, 20};
+  //Type 0 is not an RU
+  std::fill (m_rate[0], m_rate[0] + 12, 0.0);
+  for (uint32_t type = 1; type <= 4; type++)
+    {
+      for (uint32_t mcs = 0; mcs < 12; mcs++)
+        {
+          m_rate[type][mcs] = m_ruTable->GetDataRate (mcs, chanW[type]);
+        }
+    }
+
+  //RU indexes in the order of HEBitMap::GetBitMap20: nine 26-tone RUs, four
+  //52-tone RUs, two 106-tone RUs and the 242-tone RU
+  std::vector<uint32_t> bitMaps;
+  m_ruTable->GetBitMap20 (bitMaps);
+  NS_ASSERT (bitMaps.size () >= 16);
+
+  //Each half of the channel (26-tone RUs 0-3 and 5-8) is split in one of
+  //five ways; the central 26-tone RU (index 4) is used by all of them.
+  //Entries are (type, index of the first half; the second half adds 5, 2
+  //or 1 to the 26, 52 or 106-tone index).
+  static const uint8_t halves[5][4][2] = {
+    {{1, 0}, {1, 1}, {1, 2}, {1, 3}},
+    {{2, 0}, {1, 2}, {1, 3}, {0, 0}},
+    {{1, 0}, {1, 1}, {2, 1}, {0, 0}},
+    {{2, 0}, {2, 1}, {0, 0}, {0, 0}},
+    {{3, 0}, {0, 0}, {0, 0}, {0, 0}}
+  };
+  static const uint32_t firstBitMap[] = {0, 0, 9, 13, 15};
+  static const uint32_t secondHalfOffset[] = {0, 5, 2, 1};
+
+  m_partitions.clear ();
+  for (uint32_t l = 0; l < 5; l++)
+    {
+      for (uint32_t r = 0; r < 5; r++)
+        {
+          Partition p;
+          p.nRus = 0;
+          for (uint32_t k = 0; k < 4 && halves[l][k][0] != 0; k++)
+            {
+              p.ruType[p.nRus] = halves[l][k][0];
+              p.ruBitMap[p.nRus++] = bitMaps[firstBitMap[halves[l][k][0]] + halves[l][k][1]];
+            }
+          for (uint32_t k = 0; k < 4 && halves[r][k][0] != 0; k++)
+            {
+              uint8_t type = halves[r][k][0];
+              p.ruType[p.nRus] = type;
+              p.ruBitMap[p.nRus++] = bitMaps[firstBitMap[type] + halves[r][k][1] + secondHalfOffset[type]];
+            }
+          p.ruType[p.nRus] = 1;
+          p.ruBitMap[p.nRus++] = bitMaps[firstBitMap[1] + 4];
+          //Largest RUs first
+          for (uint32_t i = 1; i < p.nRus; i++)
+            {
+              for (uint32_t j = i; j > 0 && p.ruType[j] > p.ruType[j - 1]; j--)
+                {
+                  std::swap (p.ruType[j], p.ruType[j - 1]);
+                  std::swap (p.ruBitMap[j], p.ruBitMap[j - 1]);
+                }
+            }
+          m_partitions.push_back (p);
+        }
+    }
+  Partition full;
+  full.nRus = 1;
+  full.ruType[0] = 4;
+  full.ruBitMap[0] = bitMaps[firstBitMap[4]];
+  m_partitions.push_back (full);
+}
+
+uint32_t
+UtilityRRMScheduler::GetMcs (uint8_t ruType, uint32_t mcs) const
+{
+  mcs = std::min<uint32_t> (mcs, 11);
+  while (mcs > 0 && m_rate[ruType][mcs] == 0)
+    {
+      mcs--;
+    }
+  return mcs;
+}
+
+uint64_t
+UtilityRRMScheduler::GetStationKey (const uint8_t macStr[MAC_ADDR_LEN])
+{
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < MAC_ADDR_LEN; i++)
+    {
+      key = (key << 8) | macStr[i];
+    }
+  return key;
+}
+
+bool
+UtilityRRMScheduler::CompareCandidates (const Candidate &a, const Candidate &b)
+{
+  if (a.key != b.key)
+    {
+      return a.key > b.key;
+    }
+  return a.index < b.index;
+}
+
+void
+UtilityRRMScheduler::Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                               std::vector<RRMClientResponse_t> &results)
+{
+  NS_LOG_FUNCTION (this << isDownlink << stats.size ());
+  std::map<uint64_t, double> &avgRate = isDownlink ? m_avgRateDl : m_avgRateUl;
+  std::vector<Candidate> candidates;
+
+  results.clear ();
+  candidates.reserve (stats.size ());
+  for (uint32_t i = 0; i < stats.size (); i++)
+    {
+      Candidate c;
+      c.index = i;
+      //The statistics are packed, copy the depths to aligned storage
+      int depth[4];
+      if (isDownlink)
+        {
+          memcpy (depth, stats[i].bufferDepthDL, sizeof (depth));
+          c.ac = SelectAccessCategory (depth);
+          if (c.ac < 0)
+            {
+              continue;
+            }
+        }
+      else
+        {
+          //Stations without a valid BSR are polled on best effort
+          memcpy (depth, stats[i].bufferDepthUL, sizeof (depth));
+          c.ac = SelectAccessCategory (depth);
+          if (c.ac < 0)
+            {
+              c.ac = AC_BE;
+            }
+        }
+      double rate = m_rate[1][GetMcs (1, stats[i].mcsVal)];
+      c.weight = 1.0;
+      if (m_utility != MAX_RATE)
+        {
+          std::map<uint64_t, double>::iterator it = avgRate.find (GetStationKey (stats[i].macStr));
+          //A new station starts from the rate of a 26-tone RU
+          double avg = (it == avgRate.end ()) ? rate : it->second;
+          c.weight = 1.0 / std::max (avg, 1.0);
+        }
+      if (m_utility == DELAY_WEIGHTED && (c.ac == AC_VO || c.ac == AC_VI))
+        {
+          double waitingTime = isDownlink ? stats[i].WaitingTimeDL[c.ac] : stats[i].WaitingTimeUL[c.ac];
+          c.weight *= 1.0 + std::max (waitingTime, 0.0) / m_delayScale;
+        }
+      c.key = c.weight * rate;
+      candidates.push_back (c);
+    }
+  if (candidates.empty ())
+    {
+      return;
+    }
+  uint32_t nCandidates = std::min<uint32_t> (candidates.size (), 9);
+  std::partial_sort (candidates.begin (), candidates.begin () + nCandidates, candidates.end (), &UtilityRRMScheduler::CompareCandidates);
+
+  //Pick the partition with the highest total utility; partitions with
+  //more RUs than candidates leave their smallest RUs unused
+  const Partition *best = 0;
+  double bestUtility = -1;
+  for (std::vector<Partition>::const_iterator p = m_partitions.begin (); p != m_partitions.end (); p++)
+    {
+      double utility = 0;
+      uint32_t n = std::min (p->nRus, nCandidates);
+      for (uint32_t k = 0; k < n; k++)
+        {
+          const Candidate &c = candidates[k];
+          utility += c.weight * m_rate[p->ruType[k]][GetMcs (p->ruType[k], stats[c.index].mcsVal)];
+        }
+      if (utility > bestUtility)
+        {
+          bestUtility = utility;
+          best = &(*p);
+        }
+    }
+  NS_ASSERT (best != 0);
+
+  static const uint8_t chanW[] = {0, 2, 4, 8, 20};
+  uint32_t nServed = std::min (best->nRus, nCandidates);
+  std::map<uint64_t, double> servedRate;
+  for (uint32_t k = 0; k < nServed; k++)
+    {
+      const AllStats_t &s = stats[candidates[k].index];
+      uint32_t mcs = GetMcs (best->ruType[k], s.mcsVal);
+      RRMClientResponse_t resp;
+      memset (&resp, 0, sizeof (resp));
+      memcpy (resp.macStr, s.macStr, MAC_ADDR_LEN);
+      resp.trafficType = candidates[k].ac;
+      resp.ruBitMap = best->ruBitMap[k];
+      resp.mcsValue = mcs;
+      resp.chanW = chanW[best->ruType[k]];
+      results.push_back (resp);
+      servedRate[GetStationKey (s.macStr)] = m_rate[best->ruType[k]][mcs];
+    }
+
+  if (m_utility == MAX_RATE)
+    {
+      return;
+    }
+  //Exponentially weighted average of the served rate of every candidate
+  double alpha = 1.0 / m_averagingRounds;
+  for (std::vector<Candidate>::const_iterator c = candidates.begin (); c != candidates.end (); c++)
+    {
+      uint64_t key = GetStationKey (stats[c->index].macStr);
+      std::map<uint64_t, double>::iterator it = avgRate.find (key);
+      if (it == avgRate.end ())
+        {
+          it = avgRate.insert (std::make_pair (key, m_rate[1][GetMcs (1, stats[c->index].mcsVal)])).first;
+        }
+      std::map<uint64_t, double>::const_iterator served = servedRate.find (key);
+      it->second = (1 - alpha) * it->second + alpha * (served == servedRate.end () ? 0.0 : served->second);
+    }
+}
+
+} //namespace ns3
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This file is for OFDMA/802.11ax type of systems. It is not
+ * fully compliant to IEEE 802.11ax standards.
+ */
+
+#ifndef RRM_SCHEDULER_H
+#define RRM_SCHEDULER_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "ns3/object.h"
+#include "ns3/he-bitmap.h"
+#include "tlv.h"
+
+namespace ns3 {
+
+/**
+ * \brief interface of an in-process RRM scheduler plugin
+ * \ingroup wifi
+ *
+ * An RRMScheduler receives the same per-station statistics that the
+ * RRMWifiManager sends to the external RRM server (TYPE_11AX_ALL_STATS_RESP)
+ * and returns the same per-station decisions that the server sends back
+ * (TYPE_11AX_RRM_RESULTS_RESP), through direct calls instead of the TLV
+ * socket.
+ */
+class RRMScheduler : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  RRMScheduler ();
+  virtual ~RRMScheduler ();
+
+  /**
+   * \param isDownlink true if a DL MU PPDU is to be scheduled, false if
+   *        an UL trigger is to be scheduled
+   * \param stats the statistics of each associated HE station
+   * \param results the RU, MCS and access category selected for each
+   *        station to be served in this round
+   */
+  virtual void Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                         std::vector<RRMClientResponse_t> &results) = 0;
+
+protected:
+  /**
+   * Select the highest priority access category with buffered data.
+   *
+   * \param depth the buffer depth of each access category
+   * \return the access category to serve, or -1 if all queues are empty
+   */
+  static int SelectAccessCategory (const int depth[4]);
+};
+
+/**
+ * \brief round robin in-process RRM scheduler
+ * \ingroup wifi
+ *
+ * This scheduler allocates a 26-tone RU of a 20 MHz channel to each of
+ * (at most) nine stations per round. Downlink rounds only consider
+ * stations with buffered DL data; uplink rounds poll all stations in
+ * turn so that their buffer status reports stay fresh.
+ */
+class RoundRobinRRMScheduler : public RRMScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  RoundRobinRRMScheduler ();
+  virtual ~RoundRobinRRMScheduler ();
+
+  virtual void Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                         std::vector<RRMClientResponse_t> &results);
+
+private:
+  Ptr<HEBitMap> m_ruTable;     //!< RU bitmap table
+  uint32_t m_stationsPerRound; //!< maximum number of stations per round
+  uint32_t m_lastServedDl;     //!< index of the last station served in DL
+  uint32_t m_lastServedUl;     //!< index of the last station served in UL
+};
+
+/**
+ * \brief utility maximizing in-process RRM scheduler
+ * \ingroup wifi
+ *
+ * This scheduler chooses, for each round, the partition of a 20 MHz
+ * channel into 26, 52, 106 or 242-tone RUs together with the station
+ * served on each RU that maximize the sum of the per-station utilities.
+ * The utility of a station is its expected rate on the RU (from the MCS
+ * reported in the statistics) times a weight:
+ *
+ * - MaxRate: all stations have the same weight;
+ * - ProportionalFair: the weight is the inverse of the average rate
+ *   that the station was served with in previous rounds;
+ * - DelayWeighted: as ProportionalFair, with the weight of VO and VI
+ *   traffic further scaled by the head-of-line (DL) or buffer status
+ *   (UL) waiting time.
+ *
+ * The 26 partitions of a 20 MHz channel and the rate of each RU size at
+ * each MCS are computed once at construction, so that a round is a sort
+ * of the candidate stations followed by a scan of the partition table.
+ * Within a partition, candidates sorted by decreasing weighted rate are
+ * paired with RUs sorted by decreasing size. This greedy pairing is not
+ * the optimal assignment of candidates to RUs: it is only optimal when
+ * the rate of every candidate scales with the RU size in the same ratio,
+ * which does not hold when an MCS is not defined for all RU sizes. Only
+ * the nine candidates with the highest weighted rate are considered.
+ */
+class UtilityRRMScheduler : public RRMScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /// Utility maximized by the scheduler
+  enum Utility
+  {
+    MAX_RATE,
+    PROPORTIONAL_FAIR,
+    DELAY_WEIGHTED
+  };
+
+  UtilityRRMScheduler ();
+  virtual ~UtilityRRMScheduler ();
+
+  virtual void Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                         std::vector<RRMClientResponse_t> &results);
+
+private:
+  /// RUs of a partition of a 20 MHz channel, by decreasing size
+  struct Partition
+  {
+    uint32_t nRus;       //!< number of RUs
+    uint8_t ruType[9];   //!< RU type (1 to 4) of each RU
+    uint8_t ruBitMap[9]; //!< RU bitmap of each RU
+  };
+
+  /// Station competing for an RU in the current round
+  struct Candidate
+  {
+    uint32_t index; //!< index in the statistics
+    int ac;         //!< access category to serve
+    double weight;  //!< utility weight
+    double key;     //!< weighted rate on a 26-tone RU
+  };
+
+  /**
+   * Sort candidates by decreasing weighted rate.
+   *
+   * \param a the first candidate
+   * \param b the second candidate
+   * \return true if a is to be served before b
+   */
+  static bool CompareCandidates (const Candidate &a, const Candidate &b);
+  /**
+   * Build the partition and rate tables.
+   */
+  void BuildTables (void);
+  /**
+   * \param ruType the RU type (1 to 4)
+   * \param mcs the MCS reported for the station
+   * \return the highest MCS not above mcs that is defined for the RU type
+   */
+  uint32_t GetMcs (uint8_t ruType, uint32_t mcs) const;
+  /**
+   * \param macStr the MAC address of a station
+   * \return the key of the station in the average rate maps
+   */
+  static uint64_t GetStationKey (const uint8_t macStr[MAC_ADDR_LEN]);
+
+  Ptr<HEBitMap> m_ruTable;              //!< RU bitmap table
+  std::vector<Partition> m_partitions;  //!< partitions of a 20 MHz channel
+  double m_rate[5][12];                 //!< rate (bit/s) per RU type (0 is unused) and MCS
+  enum Utility m_utility;               //!< utility to maximize
+  double m_averagingRounds;             //!< averaging window of the served rate, in rounds
+  double m_delayScale;                  //!< waiting time (ms) that doubles the VO/VI weight
+  std::map<uint64_t, double> m_avgRateDl; //!< average DL rate per station
+  std::map<uint64_t, double> m_avgRateUl; //!< average UL rate per station
+};
+
+} //namespace ns3
+
+#endif /* RRM_SCHEDULER_H */
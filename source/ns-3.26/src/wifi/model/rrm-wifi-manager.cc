@@ -44,6 +44,8 @@
 #include "ns3/pointer.h"
 #include "ns3/type-id.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/he-bitmap.h"
 #include "snr-tag.h"
@@ -66,6 +68,7 @@
 #include <netdb.h>                                                       
 #include <sys/types.h>                                                   
 #include <sys/socket.h>                                                  
+#include <sys/select.h>
 #include <netinet/in.h>                                                  
 #include <sstream>                                                       
 #include <iomanip>                                                       
@@ -75,7 +78,6 @@
 #include <time.h>                                                        
 #include "tlv.h"
 
-#define PORTNUM 8888
 #define SERVERIP "localhost"
 int sd = 0 ;
 #define AC_VO 3
@@ -95,6 +97,16 @@ int sd = 0 ;
 
 namespace ns3 {
 
+/**
+ * \return a monotonic wall-clock time, in microseconds
+ */
+static uint64_t
+GetWallClockMicroSeconds (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
 
 /// To avoid using the cache before a valid value has been cached
 static const double CACHE_INITIAL_VALUE = -100;
@@ -169,51 +181,56 @@ RRMWifiManager::SendULStations(bool isEmptyBufReq){
     return 1;
 }
 
-int 
-RRMWifiManager::SendAllInfo(bool isEmptyReq)
+void
+RRMWifiManager::BuildAllStats (std::vector<AllStats_t> &stats)
 {
-  uint16_t lastServedStation = 3, totalAxStations = m_axStations.size(), i;
-  AllStats_t clientArray[100];
-  uint32_t index = 0;
-  Ptr<WifiMacQueue> queue;
+  //The first four entries are the broadcast (aid == 0) queues
+  uint16_t firstAxStation = 4, totalAxStations = m_axStations.size(), i;
   WifiMacHeader hdr;
-  //uint32_t t_ac = 0;
 
-  memset(&clientArray, '\0', sizeof(clientArray));
-  for (i = lastServedStation + 1; i < totalAxStations; i+=4)
+  stats.clear ();
+  for (i = firstAxStation; i + AC_BE_NQOS <= totalAxStations; i+=4)
   {
-      m_axStations[i]->m_state->m_address.CopyTo(clientArray[index].macStr);
+      AllStats_t clientStats;
+      memset(&clientStats, '\0', sizeof(clientStats));
+      m_axStations[i]->m_state->m_address.CopyTo(clientStats.macStr);
       uint32_t mcs = 0, mcsVal;
       for (uint32_t ac  = 0; ac < AC_BE_NQOS; ac++)
         {
 	  //Downlink buffer informtion
-	  clientArray[index].bufferDepthDL[ac] = m_axStations[i+ac]->lt->GetQueue ()->GetBytes ();
-          clientArray[index].WaitingTimeDL[ac] = std::round(Now().GetMilliSeconds() - m_axStations[i+ac]->lt->PeekFirstPacket(&hdr).GetMilliSeconds());
-          clientArray[index].ThroughputDL[ac] = m_axStations[i+ac]->lt->GetQueue ()->GetThroughput();
+	  clientStats.bufferDepthDL[ac] = m_axStations[i+ac]->lt->GetQueue ()->GetBytes ();
+          clientStats.WaitingTimeDL[ac] = std::round(Now().GetMilliSeconds() - m_axStations[i+ac]->lt->PeekFirstPacket(&hdr).GetMilliSeconds());
+          clientStats.ThroughputDL[ac] = m_axStations[i+ac]->lt->GetQueue ()->GetThroughput();
 	  //Uplink buffer information
-          clientArray[index].bufferDepthUL[ac] = m_axStations[i+ac]->ulBufferStat.bufLen;
-          clientArray[index].WaitingTimeUL[ac] = std::round(Now().GetMilliSeconds() - m_axStations[i+ac]->ulBufferStat.time.GetMilliSeconds());
+          clientStats.bufferDepthUL[ac] = m_axStations[i+ac]->ulBufferStat.bufLen;
+          clientStats.WaitingTimeUL[ac] = std::round(Now().GetMilliSeconds() - m_axStations[i+ac]->ulBufferStat.time.GetMilliSeconds());
           mcsVal = rateControlIdeal(m_axStations[i+ac]);
           if ( mcsVal != 0xff)
           mcs = mcsVal;
         }
-        clientArray[index].mcsVal = mcs;
-        //std::cout << "For station with mac " << +clientArray[index].macStr[4] << +clientArray[index].macStr[5] << " mcs : " << clientArray[index].mcsVal << std::endl;
-      index++;
+      clientStats.mcsVal = mcs;
+      stats.push_back (clientStats);
   }
+}
+
+int 
+RRMWifiManager::SendAllInfo(bool isEmptyReq)
+{
+  std::vector<AllStats_t> clientArray;
+  BuildAllStats (clientArray);
 
   TlvBuffer* message = (TlvBuffer*)malloc(sizeof(TlvBuffer));
   memset(message, 0x00, sizeof(TlvBuffer));
 
   memset(message->data, 0x00, BUFFER_DATA_MAX_SIZE);
 
-  if (index*sizeof(AllStats_t) > BUFFER_DATA_MAX_SIZE)
+  if (clientArray.size()*sizeof(AllStats_t) > BUFFER_DATA_MAX_SIZE)
     {
       // memory not enough
       NS_ASSERT_MSG(false, "Memory is not enough for all client info");
     }
 
-  tlvEncodeAllStats(message, TYPE_11AX_ALL_STATS_RESP, clientArray, index); //last is number of clients
+  tlvEncodeAllStats(message, TYPE_11AX_ALL_STATS_RESP, clientArray.data(), clientArray.size()); //last is number of clients
   write(sd, (void*)message, sizeof(TlvBuffer));
   free(message);
   return 1;
@@ -471,44 +488,41 @@ RRMWifiManager::PrintCurrentTime()
 bool 
 RRMWifiManager::HandleRRMResults(TlvBuffer* message, bool isDownlink)
 {
-	short i;
 	short count;
 	RRMClientResponse_t* respArray = 0;
-        uint32_t axStationIndex = 0;
-        WifiTxVector txVector;
-        ServingStations servingStations;
+        bool isScheduled;
 
-        servingStations.clear();
 	tlvDecodeResults(message,&respArray,&count);
-	for(i = 0;i<count;i++)
-	{
-#if 0
-		printf("\n\nRRM Results of Client[%d]:\n",i+1);
-		print_bytes(respArray[i].macStr,6);
-		printf("Traffic Type:%d\n",respArray[i].trafficType);
-		printf("RU Bit Map:%d\n",respArray[i].ruBitMap);
-		printf("MCS Value:%d\n",respArray[i].mcsValue);
-		printf("Channel Width : %d\n",respArray[i].chanW);
-                PrintCurrentTime();
-#endif
-                axStationIndex = FectchAxStationIndexFromMac(respArray[i].macStr, respArray[i].trafficType);
-                //printf("AX Index : %d\n", axStationIndex);
-                txVector = DoGetDataTxVector (m_axStations[axStationIndex], respArray[i].ruBitMap, m_axStations[axStationIndex]->m_aid, respArray[i].mcsValue);
-                txVector.SetRu(respArray[i].ruBitMap);
-                txVector.SetChannelWidth(respArray[i].chanW);
-                txVector.SetAid(m_axStations[axStationIndex]->m_aid);
-                m_axStations[axStationIndex]->dataTxVector = txVector;
-                servingStations.push_back(m_axStations[axStationIndex]);
-	}
-
+        isScheduled = ApplyRRMResults(respArray, count, isDownlink);
 	if(respArray)
 	  {
             free(respArray);
 	  }
-        if(count > 0) {
-            return StartTranmission(isDownlink, servingStations);
-        }
-        return false;
+        return isScheduled;
+}
+
+bool
+RRMWifiManager::ApplyRRMResults (const RRMClientResponse_t *respArray, short count, bool isDownlink)
+{
+  uint32_t axStationIndex = 0;
+  WifiTxVector txVector;
+  ServingStations servingStations;
+
+  for (short i = 0; i < count; i++)
+    {
+      axStationIndex = FectchAxStationIndexFromMac(respArray[i].macStr, respArray[i].trafficType);
+      txVector = DoGetDataTxVector (m_axStations[axStationIndex], respArray[i].ruBitMap, m_axStations[axStationIndex]->m_aid, respArray[i].mcsValue);
+      txVector.SetRu(respArray[i].ruBitMap);
+      txVector.SetChannelWidth(respArray[i].chanW);
+      txVector.SetAid(m_axStations[axStationIndex]->m_aid);
+      m_axStations[axStationIndex]->dataTxVector = txVector;
+      servingStations.push_back(m_axStations[axStationIndex]);
+    }
+  if (count > 0)
+    {
+      return StartTranmission(isDownlink, servingStations);
+    }
+  return false;
 }
 
 int 
@@ -734,6 +748,39 @@ RRMWifiManager::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&RRMWifiManager::m_SchedulerPluginEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Scheduler",
+                   "The in-process RRM scheduler plugin. If SchedulerPlugin is enabled and "
+                   "no scheduler is set, a RoundRobinRRMScheduler is created.",
+                   PointerValue (),
+                   MakePointerAccessor (&RRMWifiManager::m_scheduler),
+                   MakePointerChecker<RRMScheduler> ())
+    .AddAttribute ("ExternalScheduler",
+                   "If true, the scheduler plugin is the external RRM server reached "
+                   "over the TLV socket instead of the in-process Scheduler.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RRMWifiManager::m_externalScheduler),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BatchedProtocol",
+                   "If true, one snapshot of all stations is sent to the external RRM server "
+                   "per scheduling epoch, using variable-length frames.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RRMWifiManager::m_batchedProtocol),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxEpochsInFlight",
+                   "The maximum number of epochs sent to the RRM server whose results have "
+                   "not been received yet (batched protocol only). With a value of one, each "
+                   "epoch waits for its own results.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RRMWifiManager::m_maxEpochsInFlight),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ServerTimeout",
+                   "The wall-clock time to wait for the RRM server before the round is "
+                   "scheduled by the built-in sample schedulers instead. The wait of a "
+                   "round is bounded by this time as a whole, and the connection is "
+                   "opened again after a timeout of the per-request protocol.",
+                   TimeValue (MilliSeconds (500)),
+                   MakeTimeAccessor (&RRMWifiManager::m_serverTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -744,19 +791,41 @@ RRMWifiManager::RRMWifiManager ()
   m_dcf = new RRMWifiManager::Dcf (this);
   m_rng = new RealRandomStream ();
   m_ruTable = CreateObject<HEBitMap> ();
-  m_sockId = socket(AF_INET, SOCK_STREAM, 0);
-  EstablishRRMServerConnection();
+  //The RRM server is only connected once the external scheduler is used
+  m_sockId = -1;
+  m_nextEpoch = 0;
+  m_batchedResultsValid[0] = false;
+  m_batchedResultsValid[1] = false;
+  m_nextScheduleUplink = false;
+  //The first four entries of m_axStations are the broadcast queues
+  m_lastServedDl = 3;
+  m_lastServedUl = 3;
 }
 
 RRMWifiManager::~RRMWifiManager ()
 {
   NS_LOG_FUNCTION (this);
-  close(m_sockId);
+  if (m_sockId >= 0)
+    {
+      close(m_sockId);
+    }
+}
+
+void
+RRMWifiManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_scheduler = 0;
+  WifiRemoteStationManager::DoDispose ();
 }
 
 void
 RRMWifiManager::DoInitialize ()
 {
+  if (m_SchedulerPluginEnabled && !m_externalScheduler && m_scheduler == 0)
+    {
+      m_scheduler = CreateObject<RoundRobinRRMScheduler> ();
+    }
   m_wifiPhy->TraceConnectWithoutContext("PhyRxDrop", MakeCallback(&RRMWifiManager::RxDrop, this));
   WifiMode mode;
   WifiTxVector txVector;
@@ -793,6 +862,13 @@ RRMWifiManager::SetupPhy (Ptr<WifiPhy> phy)
 void
 RRMWifiManager::SetupAidQueue (uint16_t aid, Mac48Address mac, MacLowTransmissionListener *lt, enum AcIndex ac)
 {
+  //The schedulers walk m_axStations by groups of four queues, one per
+  //access category in AcIndex order, the broadcast queues first
+  NS_ASSERT_MSG (m_axStations.size () % AC_BE_NQOS == ac
+                 && (m_axStations.size () < AC_BE_NQOS) == (aid == 0)
+                 && (ac == AC_BE || m_axStations.back ()->m_aid == aid),
+                 "Queue of AID " << aid << " for AC " << ac << " set up out of order");
+  SetStationAid (mac, aid);
   for (uint8_t tid = 0; tid < 8; tid++)
     {
       if (QosUtilsMapTidToAc (tid) == ac && !(tid % 2))
@@ -812,17 +888,53 @@ RRMWifiManager::SetupAidQueue (uint16_t aid, Mac48Address mac, MacLowTransmissio
           station->m_mcsVal = 0xff;
           station->m_arfSuccessThreshold = 4;
           station->m_arfFailureThreshold = 4;
+          station->m_axIndex = m_axStations.size ();
 	  m_axStations.push_back(station);
+          m_dlBacklog.resize ((m_axStations.size () + 63) / 64, 0);
 	}
     }
 }
 
+void
+RRMWifiManager::NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac)
+{
+  NS_LOG_FUNCTION (this << aid << ac);
+  //The queue of an access category is set up on its even TID. The
+  //broadcast queues (aid 0) are not found, as they are not served by
+  //the sample scheduler.
+  static const uint8_t queueTid[AC_BE_NQOS] = {0, 2, 4, 6};
+  RRMWifiRemoteStation *station = (RRMWifiRemoteStation *)LookupByAid (aid, queueTid[ac]);
+  if (station != 0 && station->m_axIndex != 0xffff)
+    {
+      m_dlBacklog[station->m_axIndex / 64] |= (uint64_t)1 << (station->m_axIndex % 64);
+    }
+}
+
+uint16_t
+RRMWifiManager::FindDlBacklog (uint32_t from) const
+{
+  for (uint32_t w = from / 64; w < m_dlBacklog.size (); w++)
+    {
+      uint64_t word = m_dlBacklog[w];
+      if (w == from / 64)
+        {
+          word &= ~(uint64_t)0 << (from % 64);
+        }
+      if (word != 0)
+        {
+          return w * 64 + __builtin_ctzll (word);
+        }
+    }
+  return 0xffff;
+}
+
 WifiRemoteStation *
 RRMWifiManager::DoCreateStation (void) const
 {
   NS_LOG_FUNCTION (this);
   RRMWifiRemoteStation *station = new RRMWifiRemoteStation ();
   station->m_aid = 0;
+  station->m_axIndex = 0xffff;
   station->m_lastSnrObserved = 0.0;
   station->m_lastSnrCached = CACHE_INITIAL_VALUE;
   return station;
@@ -1023,11 +1135,10 @@ bool
 RRMWifiManager::ScheduleStations(void)
 {
   NS_LOG_FUNCTION(this);
-  static bool nextScheduleUplink = false;
   bool isScheduled = false;
   if (m_SchedulerPluginEnabled)
     {
-      isScheduled = CallAlgoPlugin(!nextScheduleUplink);
+      isScheduled = CallAlgoPlugin(!m_nextScheduleUplink);
     }
   else
     {
@@ -1035,7 +1146,7 @@ RRMWifiManager::ScheduleStations(void)
        * Following sample resource allocation methods are for 20MHZ only. it just allocates 26 tone resource unit
        * to each station.
        */
-      if (nextScheduleUplink)
+      if (m_nextScheduleUplink)
 	{
 	  isScheduled = SampleULScheduler();
 	}
@@ -1044,7 +1155,7 @@ RRMWifiManager::ScheduleStations(void)
 	  isScheduled = SampleDLScheduler();
 	}
     }
-  nextScheduleUplink = !nextScheduleUplink;
+  m_nextScheduleUplink = !m_nextScheduleUplink;
   return isScheduled;
 }
 
@@ -1057,47 +1168,64 @@ RRMWifiManager::SampleDLScheduler(void)
   NS_LOG_FUNCTION(this);
   uint16_t stationsPerRound = 9;
   uint16_t currListOfStations = 0;
-  static uint16_t lastServedStation = 3;
-  int16_t i;
-  uint16_t  totalAxStations = m_axStations.size();
+  uint16_t lastSelected = m_lastServedDl;
+  bool wrapped = false;
   ServingStations servingStaions;
   WifiTxVector txVector;
   struct RUInfo                     ruI = {0,0};
   uint32_t bitMap = 0;
   Ptr<UniformRandomVariable> mcsRandom = CreateObject<UniformRandomVariable> ();
 
-  for (i = lastServedStation + 1; i < totalAxStations; i++)
+  //Visit the queues that requested access, round robin from the one after
+  //the last served station, up to and including the last served station
+  uint16_t i = FindDlBacklog (m_lastServedDl + 1);
+  while (currListOfStations < stationsPerRound)
     {
-      if(m_axStations[i]->lt->NeedsAccess())
+      if (i == 0xffff)
 	{
-	      //Populate ruMap
-              ruI.type = 1;
-              bitMap = m_ruTable->GetBitMapFromRUInfo(ruI); 
-              ruI.index ++;
-
-              txVector = DoGetDataTxVector (m_axStations[i]);
-
-              //XXX: Seleting 26 tone RU for 9 stations
-              txVector.SetRu(bitMap);
-	      txVector.SetAid(m_axStations[i]->m_aid);
-              txVector.SetChannelWidth(2);
-	      m_axStations[i]->dataTxVector = txVector;
-	      servingStaions.push_back (m_axStations[i]);
-	      currListOfStations++;
-
+	  if (wrapped)
+	    {
+	      break;
+	    }
+	  wrapped = true;
+	  i = FindDlBacklog (0);
+	  continue;
 	}
-      if(i == totalAxStations - 1)
+      if (wrapped && i > m_lastServedDl)
 	{
-	  i = 3;
+	  break;
 	}
-      if ( i == lastServedStation || currListOfStations == stationsPerRound)
+      if(!m_axStations[i]->lt->NeedsAccess())
 	{
-	  break;
+	  //The queue has been emptied since it requested access
+	  m_dlBacklog[i / 64] &= ~((uint64_t)1 << (i % 64));
+	  i = FindDlBacklog (i + 1);
+	  continue;
 	}
+      //Populate ruMap
+      ruI.type = 1;
+      bitMap = m_ruTable->GetBitMapFromRUInfo(ruI);
+      ruI.index ++;
+
+      txVector = DoGetDataTxVector (m_axStations[i]);
+
+      //XXX: Seleting 26 tone RU for 9 stations
+      txVector.SetRu(bitMap);
+      txVector.SetAid(m_axStations[i]->m_aid);
+      txVector.SetChannelWidth(2);
+      m_axStations[i]->dataTxVector = txVector;
+      servingStaions.push_back (m_axStations[i]);
+      currListOfStations++;
+      lastSelected = i;
+      i = FindDlBacklog (i + 1);
     }
   if (currListOfStations)
     {
-      lastServedStation = i;
+      //A partial round ends on the last served station, as a full walk would
+      if (currListOfStations == stationsPerRound)
+	{
+	  m_lastServedDl = lastSelected;
+	}
       return StartTranmission(true, servingStaions);
     }
   return false;
@@ -1112,38 +1240,35 @@ RRMWifiManager::SampleULScheduler()
   NS_LOG_FUNCTION(this);
   uint16_t stationsPerRound = 9;
   uint16_t currListOfStations = 0;
-  static uint16_t lastServedStation = 3;
+  uint16_t lastServedStation = m_lastServedUl;
   uint16_t i;
   uint16_t  totalAxStations = m_axStations.size();
   ServingStations servingStaions;
   struct RUInfo                     ruI = {0,0};
-  std::vector<uint16_t>  selectedAid = {0}; 
-  std::vector<uint16_t>::iterator it;
 
   for (i = lastServedStation + 1; i < totalAxStations;i++)
     {
-      it = find (selectedAid.begin(), selectedAid.end(), m_axStations[i]->m_aid);
-
-      if(it == selectedAid.end())
-      { 
-         //Populate ruMap
-         WifiTxVector txVector = DoGetDataTxVector (m_axStations[i]);
-
-         //XXX: Seleting 26 tone RU for 9 stations
-         ruI.type = 1;
-         txVector.SetRu(m_ruTable->GetBitMapFromRUInfo(ruI));
-         ruI.index ++;
-
-         txVector.SetAid(m_axStations[i]->m_aid);
-         selectedAid.push_back(m_axStations[i]->m_aid);
-         m_axStations[i]->dataTxVector = txVector;
-         servingStaions.push_back (m_axStations[i]);
-         currListOfStations++;
-      }
-
+      //Populate ruMap
+      WifiTxVector txVector = DoGetDataTxVector (m_axStations[i]);
+
+      //XXX: Seleting 26 tone RU for 9 stations
+      ruI.type = 1;
+      txVector.SetRu(m_ruTable->GetBitMapFromRUInfo(ruI));
+      ruI.index ++;
+
+      txVector.SetAid(m_axStations[i]->m_aid);
+      m_axStations[i]->dataTxVector = txVector;
+      servingStaions.push_back (m_axStations[i]);
+      currListOfStations++;
+
+      //The other queues of this station share its AID, skip them (see
+      //SetupAidQueue)
+      uint16_t groupEnd = (i / AC_BE_NQOS) * AC_BE_NQOS + AC_BE_NQOS - 1;
+      i = (i < lastServedStation && lastServedStation <= groupEnd) ? lastServedStation : groupEnd;
       if(i == totalAxStations - 1)
       {
-         i = 3;
+         //Wrap around after the broadcast queues
+         i = AC_BE_NQOS - 1;
       }
       if ( i == lastServedStation || currListOfStations == stationsPerRound)
       {
@@ -1152,7 +1277,7 @@ RRMWifiManager::SampleULScheduler()
     }
   if (currListOfStations)
     {
-      lastServedStation = i;
+      m_lastServedUl = i;
       return StartTranmission(false, servingStaions);
     }
   return false;
@@ -1222,7 +1347,7 @@ RRMWifiManager::StartTranmission (bool isDownlink, ServingStations servingStatio
 }
 
 uint32_t
-RRMWifiManager::FectchAxStationIndexFromMac(uint8_t mac[6], uint8_t trafficType)
+RRMWifiManager::FectchAxStationIndexFromMac(const uint8_t mac[6], uint8_t trafficType)
 {
   uint32_t   i, axIndex = 0;
   uint32_t t_ac = 0;
@@ -1233,24 +1358,10 @@ RRMWifiManager::FectchAxStationIndexFromMac(uint8_t mac[6], uint8_t trafficType)
   {
       t_ac = QosUtilsMapTidToAc(m_axStations[i]->m_tid);
       m_axStations[i]->m_state->m_address.CopyTo(macAddr);
-      if(memcmp(macAddr, mac, 6) == 0) { 
-          if(trafficType == AC_VO) {
-              if(t_ac == AC_VO) {
-                  axIndex = i;
-                  break; 
-              }
-          } else if(trafficType == AC_VI) {
-              if(t_ac == AC_VI) { 
-                  axIndex = i; 
-                  break; 
-              }
-          } else if(trafficType == AC_BE){
-              if(t_ac == AC_BE) { 
-                  axIndex = i; 
-                  break; 
-              }
-          }
-      } 
+      if(memcmp(macAddr, mac, 6) == 0 && t_ac == trafficType) {
+          axIndex = i;
+          break;
+      }
   }
   return axIndex;
 }
@@ -1545,6 +1656,10 @@ RRMWifiManager::EstablishRRMServerConnection()
 {
 	struct sockaddr_in rrmServer ;
 	if(m_sockId < 0)
+	{
+	  m_sockId = socket(AF_INET, SOCK_STREAM, 0);
+	}
+	if(m_sockId < 0)
 	{
 		std::cout<<"The socket has not been created\n";
 	  return -1;
@@ -1560,12 +1675,27 @@ RRMWifiManager::EstablishRRMServerConnection()
 	if (connect(m_sockId, (struct sockaddr *)&rrmServer , sizeof(rrmServer)) < 0)
   {
   	NS_LOG_DEBUG("Connection to the RRM Server Failed\n");
+    //Retry with a new socket in the next round
+    close(m_sockId);
+    m_sockId = -1;
     return -1;
   }
 
 	return 1;
 }
 
+bool
+RRMWifiManager::CallSchedulerPlugin (bool isDownlink)
+{
+  NS_LOG_FUNCTION (this << isDownlink);
+  std::vector<AllStats_t> stats;
+  std::vector<RRMClientResponse_t> results;
+
+  BuildAllStats (stats);
+  m_scheduler->Schedule (isDownlink, stats, results);
+  return ApplyRRMResults (results.data (), results.size (), isDownlink);
+}
+
 bool 
 RRMWifiManager::CallAlgoPlugin(bool isDownlink)
 {
@@ -1575,6 +1705,19 @@ RRMWifiManager::CallAlgoPlugin(bool isDownlink)
     int  ret = 0;
     TlvBuffer* message = NULL;
 
+    if (!m_externalScheduler)
+    {
+        return CallSchedulerPlugin(isDownlink);
+    }
+    if (m_batchedProtocol)
+    {
+        return CallBatchedAlgoPlugin(isDownlink);
+    }
+    if (m_sockId < 0 && EstablishRRMServerConnection() < 0)
+    {
+        return CallSampleScheduler(isDownlink);
+    }
+
     message = (TlvBuffer*)malloc(sizeof(TlvBuffer));
     memset(message,0x00,sizeof(TlvBuffer));
     
@@ -1591,29 +1734,206 @@ RRMWifiManager::CallAlgoPlugin(bool isDownlink)
         FD_SET(m_sockId, &readfds); 
         max_sd = (max_sd>m_sockId)?max_sd:m_sockId;
         
-        ret = select(max_sd + 1, &readfds, NULL, NULL, NULL);
+        struct timeval tv;
+        tv.tv_sec = m_serverTimeout.GetMicroSeconds () / 1000000;
+        tv.tv_usec = m_serverTimeout.GetMicroSeconds () % 1000000;
+        ret = select(max_sd + 1, &readfds, NULL, NULL, &tv);
         if (ret < 0)
         {
             printf("select failed\n ");
             return false;
         }
+        if (ret == 0)
+        {
+            NS_LOG_WARN ("No answer from the RRM server, using the sample scheduler");
+            //A late answer would be taken for the answer of a later round,
+            //start again on a new connection
+            close(m_sockId);
+            m_sockId = -1;
+            return CallSampleScheduler(isDownlink);
+        }
         // warning: you don't know the max_sd value
         sd = m_sockId ;
         if (FD_ISSET(sd, &readfds)) 
         {
             ret = recv(sd,(char *)&recvBuf,sizeof(TlvBuffer), 0);
-            if(ret > 0 )
+            if (ret <= 0)
             {
-                if(ProcessTlvMessage(&recvBuf, isDownlink) == 1) {
-                    return 1;
-                }
-                memset(&recvBuf,0x00,sizeof(recvBuf));
+                NS_LOG_WARN ("Connection to the RRM server lost");
+                close(m_sockId);
+                m_sockId = -1;
+                return CallSampleScheduler(isDownlink);
             }
+            if(ProcessTlvMessage(&recvBuf, isDownlink) == 1) {
+                return 1;
+            }
+            memset(&recvBuf,0x00,sizeof(recvBuf));
         }
     }
     return false;
 }
 
+bool
+RRMWifiManager::CallSampleScheduler (bool isDownlink)
+{
+  if (isDownlink)
+    {
+      return SampleDLScheduler ();
+    }
+  return SampleULScheduler ();
+}
+
+bool
+RRMWifiManager::SendBatchedStats (uint32_t epoch, bool isDownlink)
+{
+  NS_LOG_FUNCTION (this << epoch << isDownlink);
+  std::vector<AllStats_t> stats;
+  TlvBatchHeader_t header;
+  std::vector<uint8_t> frame;
+  size_t written = 0;
+
+  BuildAllStats (stats);
+  header.type = htons (TYPE_11AX_BATCH_STATS_REQ);
+  header.count = htons (stats.size ());
+  header.epoch = htonl (epoch);
+  header.isDownlink = isDownlink;
+  header.frameLen = htonl (stats.size () * sizeof (AllStats_t));
+
+  frame.resize (sizeof (header) + stats.size () * sizeof (AllStats_t));
+  memcpy (frame.data (), &header, sizeof (header));
+  if (!stats.empty ())
+    {
+      memcpy (frame.data () + sizeof (header), stats.data (), stats.size () * sizeof (AllStats_t));
+    }
+  while (written < frame.size ())
+    {
+      ssize_t ret = write (m_sockId, frame.data () + written, frame.size () - written);
+      if (ret <= 0)
+        {
+          NS_LOG_WARN ("Write to the RRM server failed");
+          return false;
+        }
+      written += ret;
+    }
+  return true;
+}
+
+int
+RRMWifiManager::ReceiveBatchedResults (Time timeout)
+{
+  NS_LOG_FUNCTION (this << timeout);
+  fd_set readfds;
+  struct timeval tv;
+  uint8_t buf[4096];
+  int ret;
+
+  FD_ZERO (&readfds);
+  FD_SET (m_sockId, &readfds);
+  tv.tv_sec = timeout.GetMicroSeconds () / 1000000;
+  tv.tv_usec = timeout.GetMicroSeconds () % 1000000;
+  ret = select (m_sockId + 1, &readfds, NULL, NULL, &tv);
+  if (ret == 0)
+    {
+      return 0;
+    }
+  if (ret > 0)
+    {
+      ret = recv (m_sockId, buf, sizeof (buf), 0);
+    }
+  if (ret <= 0)
+    {
+      //The epochs in flight are lost with the connection
+      NS_LOG_WARN ("Connection to the RRM server lost");
+      close (m_sockId);
+      m_sockId = -1;
+      m_epochsInFlight.clear ();
+      m_rxBuffer.clear ();
+      return -1;
+    }
+  m_rxBuffer.insert (m_rxBuffer.end (), buf, buf + ret);
+
+  //Process every complete frame; a frame may span several reads
+  size_t offset = 0;
+  while (m_rxBuffer.size () - offset >= sizeof (TlvBatchHeader_t))
+    {
+      TlvBatchHeader_t header;
+      memcpy (&header, m_rxBuffer.data () + offset, sizeof (header));
+      uint32_t frameLen = ntohl (header.frameLen);
+      if (m_rxBuffer.size () - offset - sizeof (header) < frameLen)
+        {
+          break;
+        }
+      const uint8_t *payload = m_rxBuffer.data () + offset + sizeof (header);
+      offset += sizeof (header) + frameLen;
+      if (ntohs (header.type) != TYPE_11AX_BATCH_RESULTS_RESP)
+        {
+          NS_LOG_WARN ("Unexpected frame type " << ntohs (header.type) << " from the RRM server");
+          continue;
+        }
+      uint32_t epoch = ntohl (header.epoch);
+      std::deque<uint32_t>::iterator it = std::find (m_epochsInFlight.begin (), m_epochsInFlight.end (), epoch);
+      if (it == m_epochsInFlight.end ())
+        {
+          //Results of an epoch that has timed out
+          NS_LOG_DEBUG ("Discarding late results of epoch " << epoch);
+          continue;
+        }
+      m_epochsInFlight.erase (it);
+      uint32_t count = std::min<uint32_t> (ntohs (header.count), frameLen / sizeof (RRMClientResponse_t));
+      uint32_t dir = header.isDownlink ? 0 : 1;
+      m_batchedResults[dir].resize (count);
+      if (count > 0)
+        {
+          memcpy (m_batchedResults[dir].data (), payload, count * sizeof (RRMClientResponse_t));
+        }
+      m_batchedResultsValid[dir] = true;
+    }
+  m_rxBuffer.erase (m_rxBuffer.begin (), m_rxBuffer.begin () + offset);
+  return ret;
+}
+
+bool
+RRMWifiManager::CallBatchedAlgoPlugin (bool isDownlink)
+{
+  NS_LOG_FUNCTION (this << isDownlink);
+  uint32_t dir = isDownlink ? 0 : 1;
+
+  if (m_sockId < 0 && EstablishRRMServerConnection () < 0)
+    {
+      return CallSampleScheduler (isDownlink);
+    }
+  if (!SendBatchedStats (m_nextEpoch, isDownlink))
+    {
+      return CallSampleScheduler (isDownlink);
+    }
+  m_epochsInFlight.push_back (m_nextEpoch++);
+
+  //Collect what has already arrived, then wait while the pipeline is full
+  while (ReceiveBatchedResults (Seconds (0)) > 0)
+    {
+    }
+  //ServerTimeout bounds the whole wait, even if the server sends its
+  //results in many small reads
+  uint64_t deadline = GetWallClockMicroSeconds () + m_serverTimeout.GetMicroSeconds ();
+  while (m_epochsInFlight.size () >= m_maxEpochsInFlight)
+    {
+      uint64_t now = GetWallClockMicroSeconds ();
+      if (now >= deadline || ReceiveBatchedResults (MicroSeconds (deadline - now)) == 0)
+        {
+          NS_LOG_WARN ("No results for epoch " << m_epochsInFlight.front () << " from the RRM server");
+          m_epochsInFlight.pop_front ();
+        }
+    }
+
+  if (!m_batchedResultsValid[dir])
+    {
+      //The pipeline is still filling up or the server is late
+      return CallSampleScheduler (isDownlink);
+    }
+  m_batchedResultsValid[dir] = false;
+  return ApplyRRMResults (m_batchedResults[dir].data (), m_batchedResults[dir].size (), isDownlink);
+}
+
 void
 RRMWifiManager::rateControlDataSuccess (RRMWifiRemoteStation *st)
 {
@@ -40,6 +40,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/he-bitmap.h"
 #include "wifi-mode.h"
@@ -48,9 +49,12 @@
 #include <iostream>
 #include <fstream>
 #include "tlv.h"
+#include "rrm-scheduler.h"
 
 namespace ns3 {
 
+class RandomStream;
+
 enum RateControlAlgorithm
 {
    ARF   = 0,
@@ -73,6 +77,7 @@ typedef struct
 struct RRMWifiRemoteStation : public WifiRemoteStation
 {
   uint16_t m_aid;
+  uint16_t m_axIndex;                   //!< Index in m_axStations, or 0xffff if the queue is not set up
   MacLowTransmissionListener *lt;
   WifiTxVector      dataTxVector;
 
@@ -108,6 +113,7 @@ public:
   virtual WifiTxVector GetMuRtsTxVector (void);
 
   virtual void SetupAidQueue (uint16_t aid, Mac48Address mac, MacLowTransmissionListener *lt, AcIndex ac);
+  virtual void NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac);
   
   void SetSiMin (Time siMin);
   void SetSiMax (Time siMax);
@@ -144,6 +150,23 @@ public:
   int SendDLStations(bool isEmptyBufReq);
   int SendULStations(bool isEmptyBufReq);
   int SendAllInfo(bool isEmptyReq);
+  /**
+   * Fill the statistics of every associated HE station, in the format
+   * exchanged with the RRM scheduler plugins.
+   *
+   * \param stats the vector to fill
+   */
+  void BuildAllStats (std::vector<AllStats_t> &stats);
+  /**
+   * Apply the decisions of an RRM scheduler plugin and start the
+   * corresponding MU transmission.
+   *
+   * \param respArray the per-station decisions
+   * \param count the number of entries in respArray
+   * \param isDownlink true for a DL MU PPDU, false for an UL trigger
+   * \return true if a transmission has been started
+   */
+  bool ApplyRRMResults (const RRMClientResponse_t *respArray, short count, bool isDownlink);
   int GetRUMCS(short station_id,short *mcs,short *ru);
   int HandleDLMCSInfoRequest(TlvBuffer* message);
   int HandleULMCSInfoRequest(TlvBuffer* message);
@@ -161,6 +184,7 @@ private:
   friend class Dcf;
   //overriden from base class
   virtual void DoInitialize (void);
+  virtual void DoDispose (void);
   virtual WifiRemoteStation* DoCreateStation (void) const;
   virtual void DoReportRxOk (WifiRemoteStation *station,
                              double rxSnr, WifiMode txMode);
@@ -222,6 +246,12 @@ private:
    * Round Robin Scheduler Downlink
    */
   bool SampleDLScheduler();
+  /**
+   * \param from an index in m_axStations
+   * \return the first index, from the given one onwards, of a queue that
+   *         requested access, or 0xffff if there is none
+   */
+  uint16_t FindDlBacklog (uint32_t from) const;
   /**
     * Round Robin Scheduler Uplink
     */
@@ -231,6 +261,43 @@ private:
    */
   int EstablishRRMServerConnection();
   bool CallAlgoPlugin(bool isDownlink);
+  /**
+   * Run one scheduling round through the in-process RRM scheduler.
+   *
+   * \param isDownlink true for a DL MU PPDU, false for an UL trigger
+   * \return true if a transmission has been started
+   */
+  bool CallSchedulerPlugin (bool isDownlink);
+  /**
+   * Run one scheduling round through the external RRM server using the
+   * batched protocol: the snapshot of all stations is sent in a single
+   * frame and up to MaxEpochsInFlight epochs may wait for their results.
+   *
+   * \param isDownlink true for a DL MU PPDU, false for an UL trigger
+   * \return true if a transmission has been started
+   */
+  bool CallBatchedAlgoPlugin (bool isDownlink);
+  /**
+   * \param epoch the scheduling epoch
+   * \param isDownlink true for a DL MU PPDU, false for an UL trigger
+   * \return true if the whole frame has been written to the RRM server
+   */
+  bool SendBatchedStats (uint32_t epoch, bool isDownlink);
+  /**
+   * Read what the RRM server has sent and process the complete batched
+   * frames received so far.
+   *
+   * \param timeout how long to wait for data (zero to only poll)
+   * \return the number of bytes read, zero on timeout, negative on error
+   */
+  int ReceiveBatchedResults (Time timeout);
+  /**
+   * Run the built-in sample scheduler of the given direction.
+   *
+   * \param isDownlink true for a DL MU PPDU, false for an UL trigger
+   * \return true if a transmission has been started
+   */
+  bool CallSampleScheduler (bool isDownlink);
  
   typedef std::vector <RRMWifiRemoteStation *> AxStations;
   typedef std::vector<RRMWifiRemoteStation *> ServingStations;
@@ -245,7 +312,7 @@ private:
   /**
    *
    */
-  uint32_t FectchAxStationIndexFromMac(uint8_t mac[6], uint8_t trafficType);
+  uint32_t FectchAxStationIndexFromMac(const uint8_t mac[6], uint8_t trafficType);
   /**
    * make the UL buffer status invalid if the stale timer expired
    */
@@ -327,6 +394,20 @@ private:
   double m_ber;             //!< The maximum Bit Error Rate acceptable at any transmission mode
   Thresholds m_thresholds;  //!< List of WifiTxVector and the minimum SNR pair
   bool m_SchedulerPluginEnabled;
+  bool m_externalScheduler;          //!< Use the external RRM server over the TLV socket
+  Ptr<RRMScheduler> m_scheduler;     //!< In-process RRM scheduler plugin
+  bool m_batchedProtocol;            //!< Use the batched protocol with the RRM server
+  uint32_t m_maxEpochsInFlight;      //!< Maximum number of epochs awaiting results
+  Time m_serverTimeout;              //!< Receive timeout before falling back to the sample schedulers
+  uint32_t m_nextEpoch;              //!< Epoch of the next batched request
+  std::deque<uint32_t> m_epochsInFlight;  //!< Epochs whose results have not been received
+  std::vector<uint8_t> m_rxBuffer;   //!< Bytes received from the RRM server, not yet processed
+  std::vector<RRMClientResponse_t> m_batchedResults[2]; //!< Latest DL (0) and UL (1) results
+  bool m_batchedResultsValid[2];     //!< Whether m_batchedResults has not been applied yet
+  bool m_nextScheduleUplink;         //!< Whether the next sample scheduling round is UL
+  uint16_t m_lastServedDl;           //!< Index in m_axStations of the last station served in DL
+  uint16_t m_lastServedUl;           //!< Index in m_axStations of the last station polled in UL
+  std::vector<uint64_t> m_dlBacklog; //!< Bitmap, indexed like m_axStations, of the queues that requested access
 };
 
 }
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "table-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+//Table entries of a chunk success rate of 1 and 0
+static const double LOG_NO_ERROR = -745.0;
+static const double LOG_ALL_ERRORS = std::log (1000.0);
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model to tabulate. If not set, a NistErrorRateModel "
+                   "is created at the first query.",
+                   PointerValue (),
+                   MakePointerAccessor (&TableErrorRateModel::m_errorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The SNR (dB) of the first entry of the tables.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The SNR (dB) of the last entry of the tables.",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The SNR step (dB) of the tables.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_snrStepDb),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_errorRateModel = 0;
+  m_tables.clear ();
+}
+
+bool
+TableErrorRateModel::TableKey::operator < (const TableKey &o) const
+{
+  if (mode != o.mode)
+    {
+      return mode < o.mode;
+    }
+  if (channelWidth != o.channelWidth)
+    {
+      return channelWidth < o.channelWidth;
+    }
+  if (shortGuardInterval != o.shortGuardInterval)
+    {
+      return shortGuardInterval < o.shortGuardInterval;
+    }
+  return nss < o.nss;
+}
+
+const std::vector<double> &
+TableErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  TableKey key;
+  key.mode = mode.GetUid ();
+  key.channelWidth = txVector.GetChannelWidth ();
+  key.shortGuardInterval = txVector.IsShortGuardInterval ();
+  key.nss = txVector.GetNss ();
+  std::map<TableKey, std::vector<double> >::const_iterator it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_DEBUG ("building table of mode " << mode << " for " << key.channelWidth << " MHz, "
+                << (key.shortGuardInterval ? "short" : "long") << " GI, " << +key.nss << " streams");
+  NS_ASSERT (m_maxSnrDb > m_minSnrDb);
+  uint32_t n = static_cast<uint32_t> (std::ceil ((m_maxSnrDb - m_minSnrDb) / m_snrStepDb)) + 1;
+  std::vector<double> &table = m_tables[key];
+  table.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_snrStepDb) / 10.0);
+      double csr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 1);
+      if (csr >= 1)
+        {
+          table[i] = LOG_NO_ERROR;
+        }
+      else if (csr <= 0)
+        {
+          table[i] = LOG_ALL_ERRORS;
+        }
+      else
+        {
+          table[i] = std::min (std::log (-std::log (csr)), LOG_ALL_ERRORS);
+        }
+    }
+  return table;
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits);
+  if (m_errorRateModel == 0)
+    {
+      m_errorRateModel = CreateObject<NistErrorRateModel> ();
+    }
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS)
+    {
+      return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  double x = snr > 0 ? (10.0 * std::log10 (snr) - m_minSnrDb) / m_snrStepDb : -1;
+  const std::vector<double> &table = GetTable (mode, txVector);
+  if (x < 0 || x >= table.size () - 1)
+    {
+      return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double w = x - i;
+  double y = (1 - w) * table[i] + w * table[i + 1];
+  return std::exp (-std::exp (y) * nbits);
+}
+
+} //namespace ns3
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief tabulated version of an OFDM error rate model
+ * \ingroup wifi
+ *
+ * This model wraps another error rate model whose chunk success rate is
+ * of the form (1 - pe)^nbits, which is the case of the OFDM modes of
+ * NistErrorRateModel and YansErrorRateModel. For each mode, channel
+ * width, guard interval and number of spatial streams, which are the
+ * TXVECTOR fields these models read, it tabulates log (-log (1 - pe)) on
+ * a grid of SNRs in dB, the first time the combination is used, and
+ * interpolates linearly in between.
+ *
+ * With the default 0.05 dB step, the chunk success rate of a 2000 byte
+ * chunk differs by less than 1e-4 from the one of NistErrorRateModel.
+ * SNRs outside of the grid, and DSSS/HR-DSSS modes, are passed on to the
+ * wrapped model. If no model is set, a NistErrorRateModel is created at
+ * the first query.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Mode and TXVECTOR fields a table is built for
+  struct TableKey
+  {
+    uint32_t mode;           //!< UID of the mode
+    uint32_t channelWidth;   //!< channel width in MHz
+    bool shortGuardInterval; //!< whether the short guard interval is used
+    uint8_t nss;             //!< number of spatial streams
+
+    bool operator < (const TableKey &o) const;
+  };
+
+  /**
+   * \param mode the mode
+   * \param txVector the TXVECTOR of the PPDU
+   *
+   * \return log (-log (1 - pe)) at each SNR of the grid
+   */
+  const std::vector<double> & GetTable (WifiMode mode, WifiTxVector txVector) const;
+
+  mutable Ptr<ErrorRateModel> m_errorRateModel;              //!< Wrapped model
+  double m_minSnrDb;                                         //!< SNR of the first entry of the tables
+  double m_maxSnrDb;                                         //!< SNR of the last entry of the tables
+  double m_snrStepDb;                                        //!< SNR step of the tables
+  mutable std::map<TableKey, std::vector<double> > m_tables; //!< Table per mode and TXVECTOR fields
+};
+
+} //namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -75,12 +75,18 @@
 #define TYPE_11AX_ALL_STATS_REQ 27
 #define TYPE_11AX_ALL_STATS_RESP 28
 
+#define TYPE_11AX_BATCH_STATS_REQ 29
+#define TYPE_11AX_BATCH_RESULTS_RESP 30
+
 #define TYPE_11AX_ALGO_END 254
 
 #define TYPE_11AX_RRM_QOS_END 255
 
 #define BUFFER_DATA_MAX_SIZE 15000
 
+/* TCP port of the RRM server, on the local host */
+#define PORTNUM 8888
+
 typedef struct{
 char data[BUFFER_DATA_MAX_SIZE];
 int write_offset,read_offset;
@@ -109,6 +115,22 @@ typedef struct
         uint8_t chanW;
 }__attribute__((packed))RRMClientResponse_t;
 
+/*
+ * Header of a frame of the batched RRM protocol. A TYPE_11AX_BATCH_STATS_REQ
+ * frame carries one AllStats_t snapshot of all stations per scheduling epoch,
+ * and the matching TYPE_11AX_BATCH_RESULTS_RESP frame carries the
+ * RRMClientResponse_t decisions for the same epoch. The header fields are in
+ * network byte order; frameLen is the number of bytes following the header.
+ */
+typedef struct
+{
+        uint16_t type;
+        uint16_t count;
+        uint32_t epoch;
+        uint8_t isDownlink;
+        uint32_t frameLen;
+}__attribute__((packed))TlvBatchHeader_t;
+
 
 #if 0
 int tlvWriteTypeLen(TlvBuffer* buf,short type,short len);
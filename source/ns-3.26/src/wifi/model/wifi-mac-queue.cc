@@ -37,8 +37,10 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -49,7 +51,12 @@ WifiMacQueue::Item::Item (Ptr<const Packet> packet,
                           Time tstamp)
   : packet (packet),
     hdr (hdr),
-    tstamp (tstamp)
+    tstamp (tstamp),
+    flow (0),
+    flowPrev (0),
+    flowNext (0),
+    arrivalPrev (0),
+    arrivalNext (0)
 {
 }
 
@@ -73,12 +80,21 @@ WifiMacQueue::GetTypeId (void)
                    MakeEnumAccessor (&WifiMacQueue::m_dropPolicy),
                    MakeEnumChecker (WifiMacQueue::DROP_OLDEST, "DropOldest",
                                     WifiMacQueue::DROP_NEWEST, "DropNewest"))
+    .AddAttribute ("Indexed",
+                   "Index the QoS data packets by receiver address and TID, and all packets "
+                   "by arrival time, so that lookups by TID and address and lifetime expiry "
+                   "do not scan the queue.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiMacQueue::SetIndexed,
+                                        &WifiMacQueue::GetIndexed),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_size (0), m_servedBytes (0), m_afterQueueDrop (0), m_beforeQueueDrop (0)
+  : m_size (0), m_bytes (0), m_indexed (false), m_oldest (0), m_newest (0),
+    m_servedBytes (0), m_afterQueueDrop (0), m_beforeQueueDrop (0)
 {
   m_startTrafficTime = Now();
 }
@@ -126,6 +142,214 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
+void
+WifiMacQueue::SetIndexed (bool indexed)
+{
+  m_flows.clear ();
+  m_oldest = 0;
+  m_newest = 0;
+  m_indexed = indexed;
+  if (!m_indexed)
+    {
+      return;
+    }
+  //Link the items in queue order and then the arrival list in timestamp
+  //order, since PushFront may have put recent items ahead of older ones
+  std::vector<Item *> items;
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+    {
+      Link (it);
+      items.push_back (&(*it));
+    }
+  std::stable_sort (items.begin (), items.end (), &WifiMacQueue::IsOlder);
+  m_oldest = 0;
+  m_newest = 0;
+  for (std::vector<Item *>::const_iterator i = items.begin (); i != items.end (); i++)
+    {
+      (*i)->arrivalPrev = m_newest;
+      (*i)->arrivalNext = 0;
+      if (m_newest != 0)
+        {
+          m_newest->arrivalNext = *i;
+        }
+      else
+        {
+          m_oldest = *i;
+        }
+      m_newest = *i;
+    }
+}
+
+bool
+WifiMacQueue::GetIndexed (void) const
+{
+  return m_indexed;
+}
+
+bool
+WifiMacQueue::IsOlder (const Item *a, const Item *b)
+{
+  return a->tstamp < b->tstamp;
+}
+
+void
+WifiMacQueue::Insert (PacketQueueI pos, Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tstamp)
+{
+  PacketQueueI it;
+  if (m_pool.empty ())
+    {
+      it = m_queue.insert (pos, Item (packet, hdr, tstamp));
+    }
+  else
+    {
+      it = m_pool.begin ();
+      it->packet = packet;
+      it->hdr = hdr;
+      it->tstamp = tstamp;
+      m_queue.splice (pos, m_pool, it);
+    }
+  it->self = it;
+  m_size++;
+  m_bytes += packet->GetSize ();
+  if (m_indexed)
+    {
+      Link (it);
+    }
+}
+
+void
+WifiMacQueue::Erase (PacketQueueI it)
+{
+  if (m_indexed)
+    {
+      Unlink (it);
+    }
+  m_size--;
+  m_bytes -= it->packet->GetSize ();
+  it->packet = 0;
+  m_pool.splice (m_pool.begin (), m_queue, it);
+}
+
+void
+WifiMacQueue::Link (PacketQueueI it)
+{
+  Item *item = &(*it);
+  //Items are always enqueued with the current time, so the arrival list
+  //is sorted by timestamp and its head is the next item to expire
+  item->arrivalPrev = m_newest;
+  item->arrivalNext = 0;
+  if (m_newest != 0)
+    {
+      m_newest->arrivalNext = item;
+    }
+  else
+    {
+      m_oldest = item;
+    }
+  m_newest = item;
+
+  item->flow = 0;
+  item->flowPrev = 0;
+  item->flowNext = 0;
+  if (!item->hdr.IsQosData ())
+    {
+      return;
+    }
+  std::map<FlowKey, Flow>::iterator f = m_flows.find (FlowKey (item->hdr.GetAddr1 (), item->hdr.GetQosTid ()));
+  if (f == m_flows.end ())
+    {
+      Flow flow = {0, 0, 0};
+      f = m_flows.insert (std::make_pair (FlowKey (item->hdr.GetAddr1 (), item->hdr.GetQosTid ()), flow)).first;
+    }
+  Flow *flow = &f->second;
+  item->flow = flow;
+  flow->nPackets++;
+  //The item is either the last or the first of the queue
+  if (it != m_queue.begin ())
+    {
+      item->flowPrev = flow->tail;
+      if (flow->tail != 0)
+        {
+          flow->tail->flowNext = item;
+        }
+      else
+        {
+          flow->head = item;
+        }
+      flow->tail = item;
+    }
+  else
+    {
+      item->flowNext = flow->head;
+      if (flow->head != 0)
+        {
+          flow->head->flowPrev = item;
+        }
+      else
+        {
+          flow->tail = item;
+        }
+      flow->head = item;
+    }
+}
+
+void
+WifiMacQueue::Unlink (PacketQueueI it)
+{
+  Item *item = &(*it);
+  if (item->arrivalPrev != 0)
+    {
+      item->arrivalPrev->arrivalNext = item->arrivalNext;
+    }
+  else
+    {
+      m_oldest = item->arrivalNext;
+    }
+  if (item->arrivalNext != 0)
+    {
+      item->arrivalNext->arrivalPrev = item->arrivalPrev;
+    }
+  else
+    {
+      m_newest = item->arrivalPrev;
+    }
+
+  Flow *flow = item->flow;
+  if (flow == 0)
+    {
+      return;
+    }
+  if (item->flowPrev != 0)
+    {
+      item->flowPrev->flowNext = item->flowNext;
+    }
+  else
+    {
+      flow->head = item->flowNext;
+    }
+  if (item->flowNext != 0)
+    {
+      item->flowNext->flowPrev = item->flowPrev;
+    }
+  else
+    {
+      flow->tail = item->flowPrev;
+    }
+  flow->nPackets--;
+  item->flow = 0;
+}
+
+WifiMacQueue::Item *
+WifiMacQueue::FindFirst (Mac48Address addr, uint8_t tid)
+{
+  std::map<FlowKey, Flow>::const_iterator f = m_flows.find (FlowKey (addr, tid));
+  if (f == m_flows.end ())
+    {
+      return 0;
+    }
+  return f->second.head;
+}
+
 void
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
@@ -147,13 +371,11 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
         }
       else if (m_dropPolicy == DROP_OLDEST)
         {
-          m_queue.pop_front ();
-          m_size--;
+          Erase (m_queue.begin ());
         }
     }
   Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
-  m_size++;
+  Insert (m_queue.end (), packet, hdr, now);
 }
 
 void
@@ -165,7 +387,18 @@ WifiMacQueue::Cleanup (void)
     }
 
   Time now = Simulator::Now ();
-  uint32_t n = 0;
+  if (m_indexed)
+    {
+      while (m_oldest != 0 && m_oldest->tstamp + m_maxDelay <= now)
+        {
+          uint32_t size = m_oldest->packet->GetSize ();
+          Erase (m_oldest->self);
+          if (size != 508){
+            m_afterQueueDrop++;
+          }
+        }
+      return;
+    }
   for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
     {
       if (i->tstamp + m_maxDelay > now)
@@ -175,15 +408,13 @@ WifiMacQueue::Cleanup (void)
       else
         {
           uint32_t size = (i->packet)->GetSize();
-          i = m_queue.erase (i);
+          Erase (i++);
           //std::cout<<"Drop due to queue delay... Time" << i->tstamp <<  ":" << m_maxDelay << ":" << now << " and Size : " << size << std::endl;
           if (size != 508){
             m_afterQueueDrop++;
           }
-          n++;
         }
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -192,12 +423,11 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      m_servedBytes = m_servedBytes + i.packet->GetSize();
-      *hdr = i.hdr;
-      return i.packet;
+      Ptr<const Packet> packet = m_queue.front ().packet;
+      *hdr = m_queue.front ().hdr;
+      Erase (m_queue.begin ());
+      m_servedBytes = m_servedBytes + packet->GetSize();
+      return packet;
     }
   return 0;
 }
@@ -208,9 +438,8 @@ WifiMacQueue::Peek (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      *hdr = i.hdr;
-      return i.packet;
+      *hdr = m_queue.front ().hdr;
+      return m_queue.front ().packet;
     }
   return 0;
 }
@@ -221,6 +450,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
+  if (m_indexed && type == WifiMacHeader::ADDR1)
+    {
+      Item *item = FindFirst (dest, tid);
+      if (item != 0)
+        {
+          packet = item->packet;
+          *hdr = item->hdr;
+          Erase (item->self);
+          m_servedBytes = m_servedBytes + packet->GetSize();
+        }
+      return packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -233,9 +474,8 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
+                  Erase (it);
                   m_servedBytes = m_servedBytes + packet->GetSize();
-                  m_size--;
                   break;
                 }
             }
@@ -249,6 +489,17 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
 {
   Cleanup ();
+  if (m_indexed && type == WifiMacHeader::ADDR1)
+    {
+      Item *item = FindFirst (dest, tid);
+      if (item != 0)
+        {
+          *hdr = item->hdr;
+          *timestamp = item->tstamp;
+          return item->packet;
+        }
+      return 0;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -287,13 +538,7 @@ uint32_t
 WifiMacQueue::GetBytes (void)
 {
   Cleanup ();
-  uint32_t bytes = 0;
-  PacketQueueI it = m_queue.begin ();
-  for (; it != m_queue.end (); it++)
-    {
-      bytes += it->packet->GetSize();
-    }
-  return bytes;
+  return m_bytes;
 }
 
 double
@@ -306,8 +551,16 @@ WifiMacQueue::GetThroughput (void)
 void
 WifiMacQueue::Flush (void)
 {
-  m_queue.erase (m_queue.begin (), m_queue.end ());
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+    {
+      it->packet = 0;
+    }
+  m_pool.splice (m_pool.begin (), m_queue);
+  m_flows.clear ();
+  m_oldest = 0;
+  m_newest = 0;
   m_size = 0;
+  m_bytes = 0;
 }
 
 Mac48Address
@@ -337,8 +590,7 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -357,8 +609,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  Insert (m_queue.begin (), packet, hdr, now);
 }
 
 uint32_t
@@ -366,6 +617,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (m_indexed && type == WifiMacHeader::ADDR1)
+    {
+      std::map<FlowKey, Flow>::const_iterator f = m_flows.find (FlowKey (addr, tid));
+      return (f == m_flows.end ()) ? 0 : f->second.nPackets;
+    }
   uint32_t nPackets = 0;
   if (!m_queue.empty ())
     {
@@ -398,9 +654,8 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
+          Erase (it);
           m_servedBytes = m_servedBytes + packet->GetSize();
-          m_size--;
           return packet;
         }
     }
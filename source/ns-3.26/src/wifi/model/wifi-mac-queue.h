@@ -38,6 +38,7 @@
 
 #include <list>
 #include <utility>
+#include <map>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
@@ -60,6 +61,11 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * When the Indexed attribute is set, the queue also keeps the QoS data
+ * packets of each (receiver address, TID) pair in a FIFO and all packets
+ * in arrival order, so that the lookups by TID and receiver address and
+ * the lifetime expiry take constant time instead of a scan of the queue.
  */
 class WifiMacQueue : public Object
 {
@@ -98,6 +104,16 @@ public:
    * \return the maximum delay
    */
   Time GetMaxDelay (void) const;
+  /**
+   * Enable or disable the per (receiver address, TID) index.
+   *
+   * \param indexed true to index the queue, false otherwise
+   */
+  void SetIndexed (bool indexed);
+  /**
+   * \return true if the queue is indexed, false otherwise
+   */
+  bool GetIndexed (void) const;
 
   /**
    * Enqueue the given packet and its corresponding WifiMacHeader at the <i>end</i> of the queue.
@@ -254,6 +270,8 @@ protected:
    */
   virtual void Cleanup (void);
 
+  struct Flow;
+
   /**
    * A struct that holds information about a packet for putting
    * in a packet queue.
@@ -273,6 +291,23 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr;        //!< Wifi MAC header associated with the packet
     Time tstamp;              //!< timestamp when the packet arrived at the queue
+    std::list<Item>::iterator self; //!< position of the item in the queue
+    Flow *flow;               //!< (address, TID) FIFO of the item, if indexed
+    Item *flowPrev;           //!< previous item of the same flow
+    Item *flowNext;           //!< next item of the same flow
+    Item *arrivalPrev;        //!< previously enqueued item (indexed queue only)
+    Item *arrivalNext;        //!< next enqueued item (indexed queue only)
+  };
+
+  /**
+   * The QoS data packets queued for a (receiver address, TID) pair, in
+   * queue order.
+   */
+  struct Flow
+  {
+    Item *head;         //!< first item
+    Item *tail;         //!< last item
+    uint32_t nPackets;  //!< number of items
   };
 
   /**
@@ -296,9 +331,57 @@ protected:
    * \return the address
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  /**
+   * Insert an item in the queue, reusing a pooled list node if any.
+   *
+   * \param pos the position before which the item is inserted
+   * \param packet the packet
+   * \param hdr the header of the packet
+   * \param tstamp the arrival time of the packet
+   */
+  void Insert (PacketQueueI pos, Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tstamp);
+  /**
+   * Remove an item from the queue and return its list node to the pool.
+   *
+   * \param it the item
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * Add an item to the index.
+   *
+   * \param it the item, already in the queue
+   */
+  void Link (PacketQueueI it);
+  /**
+   * Remove an item from the index.
+   *
+   * \param it the item
+   */
+  void Unlink (PacketQueueI it);
+  /**
+   * \param addr the receiver address
+   * \param tid the TID
+   * \return the first QoS data item for the pair, or 0 if none
+   */
+  Item * FindFirst (Mac48Address addr, uint8_t tid);
+  /**
+   * \param a an item
+   * \param b another item
+   * \return true if a arrived before b
+   */
+  static bool IsOlder (const Item *a, const Item *b);
+
+  /// Key of the FIFO of a (receiver address, TID) pair
+  typedef std::pair<Mac48Address, uint8_t> FlowKey;
 
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  PacketQueue m_pool;  //!< unused list nodes
   uint32_t m_size;     //!< Current queue size
+  uint32_t m_bytes;    //!< Current queue byte size
+  bool m_indexed;      //!< whether the index below is maintained
+  std::map<FlowKey, Flow> m_flows; //!< QoS data FIFO per (receiver address, TID)
+  Item *m_oldest;      //!< first item in arrival order (indexed queue only)
+  Item *m_newest;      //!< last item in arrival order (indexed queue only)
   double   m_servedBytes;
   uint32_t m_maxSize;  //!< Queue capacity
   Time m_maxDelay;     //!< Time to live for packets in the queue
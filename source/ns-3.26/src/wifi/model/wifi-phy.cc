@@ -1768,6 +1768,11 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, WifiPreamble
 {
   WifiMode payloadMode = txVector.GetMode ();
   NS_LOG_FUNCTION (size << payloadMode);
+  if (mpdutype != MPDU_IN_AGGREGATE)
+    {
+      //HE MU padding ends the PSDU, i.e. it follows the last MPDU
+      size += txVector.GetPadding ();
+    }
 
   switch (payloadMode.GetModulationClass ())
     {
@@ -2061,11 +2066,94 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, WifiPreamble
     }
 }
 
+bool
+WifiPhy::TxDurationKey::operator < (const TxDurationKey &o) const
+{
+  if (size != o.size)
+    {
+      return size < o.size;
+    }
+  if (padding != o.padding)
+    {
+      return padding < o.padding;
+    }
+  if (modeUid != o.modeUid)
+    {
+      return modeUid < o.modeUid;
+    }
+  if (channelWidth != o.channelWidth)
+    {
+      return channelWidth < o.channelWidth;
+    }
+  if (shortGuardInterval != o.shortGuardInterval)
+    {
+      return shortGuardInterval < o.shortGuardInterval;
+    }
+  if (nss != o.nss)
+    {
+      return nss < o.nss;
+    }
+  if (ness != o.ness)
+    {
+      return ness < o.ness;
+    }
+  if (stbc != o.stbc)
+    {
+      return stbc < o.stbc;
+    }
+  if (preamble != o.preamble)
+    {
+      return preamble < o.preamble;
+    }
+  return frequency < o.frequency;
+}
+
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, WifiPreamble preamble, double frequency, enum mpduType mpdutype, uint8_t incFlag)
 {
-  return CalculatePlcpPreambleAndHeaderDuration (txVector, preamble)
-      + GetPayloadDuration (size, txVector, preamble, frequency, mpdutype, incFlag);
+  if (mpdutype != NORMAL_MPDU)
+    {
+      //MPDUs of an A-MPDU depend on the previous ones
+      return CalculatePlcpPreambleAndHeaderDuration (txVector, preamble)
+          + GetPayloadDuration (size, txVector, preamble, frequency, mpdutype, incFlag);
+    }
+  TxDurationKey key;
+  key.size = size;
+  key.padding = txVector.GetPadding ();
+  key.modeUid = txVector.GetMode ().GetUid ();
+  key.channelWidth = txVector.GetChannelWidth ();
+  key.shortGuardInterval = txVector.IsShortGuardInterval ();
+  key.nss = txVector.GetNss ();
+  key.ness = txVector.GetNess ();
+  key.stbc = txVector.IsStbc ();
+  key.preamble = preamble;
+  key.frequency = frequency;
+  std::map<TxDurationKey, Time>::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      return it->second;
+    }
+  Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector, preamble)
+    + GetPayloadDuration (size, txVector, preamble, frequency, mpdutype, incFlag);
+  if (m_txDurationCache.size () >= 4096)
+    {
+      //Bound the memory used by unusual size distributions
+      m_txDurationCache.clear ();
+    }
+  m_txDurationCache.insert (std::make_pair (key, duration));
+  return duration;
+}
+
+void
+WifiPhy::CalculateTxDurations (const std::vector<uint32_t> &sizes, const std::vector<WifiTxVector> &txVectors,
+                               WifiPreamble preamble, double frequency, std::vector<Time> &durations)
+{
+  NS_ASSERT (sizes.size () == txVectors.size ());
+  durations.resize (sizes.size ());
+  for (uint32_t i = 0; i < sizes.size (); i++)
+    {
+      durations[i] = CalculateTxDuration (sizes[i], txVectors[i], preamble, frequency, NORMAL_MPDU, 0);
+    }
 }
 
 Time
@@ -365,6 +365,18 @@ public:
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txVector, enum WifiPreamble preamble, double frequency, enum mpduType mpdutype, uint8_t incFlag);
+  /**
+   * Compute the transmission durations of the PSDUs of all users of an
+   * MU PPDU at once.
+   *
+   * \param sizes the number of bytes in the PSDU of each user
+   * \param txVectors the TXVECTOR of each user
+   * \param preamble the type of preamble to use for the PPDU
+   * \param frequency the channel center frequency (MHz)
+   * \param durations the transmission duration of each user
+   */
+  void CalculateTxDurations (const std::vector<uint32_t> &sizes, const std::vector<WifiTxVector> &txVectors,
+                             enum WifiPreamble preamble, double frequency, std::vector<Time> &durations);
 
   /**
    * \param txVector the transmission parameters used for this packet
@@ -1932,6 +1944,24 @@ private:
   uint16_t             m_initialChannelNumber;  //!< Initial channel number
 
   Time m_channelSwitchDelay;     //!< Time required to switch between channel
+  /// Parameters that determine the duration of a non-aggregated PSDU
+  struct TxDurationKey
+  {
+    uint32_t size;          //!< PSDU size in bytes
+    uint32_t padding;       //!< padding octets
+    uint32_t modeUid;       //!< payload mode
+    uint32_t channelWidth;  //!< channel width in MHz
+    bool shortGuardInterval; //!< short guard interval
+    uint8_t nss;            //!< number of spatial streams
+    uint8_t ness;           //!< number of extension spatial streams
+    bool stbc;              //!< STBC
+    WifiPreamble preamble;  //!< preamble type
+    double frequency;       //!< channel center frequency
+
+    bool operator < (const TxDurationKey &o) const;
+  };
+
+  std::map<TxDurationKey, Time> m_txDurationCache; //!< Memoized durations of non-aggregated PSDUs
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "wifi-profiler.h"
+
+namespace ns3 {
+
+bool WifiProfiler::m_enabled = false;
+uint32_t WifiProfiler::m_depth[WifiProfiler::N_PROBES] = {0};
+uint64_t WifiProfiler::m_calls[WifiProfiler::N_PROBES] = {0};
+uint64_t WifiProfiler::m_nanoSeconds[WifiProfiler::N_PROBES] = {0};
+
+void
+WifiProfiler::Enable (void)
+{
+  m_enabled = true;
+}
+
+void
+WifiProfiler::Disable (void)
+{
+  m_enabled = false;
+}
+
+bool
+WifiProfiler::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+void
+WifiProfiler::Reset (void)
+{
+  for (uint32_t i = 0; i < N_PROBES; i++)
+    {
+      m_calls[i] = 0;
+      m_nanoSeconds[i] = 0;
+    }
+}
+
+uint64_t
+WifiProfiler::GetCalls (enum Probe probe)
+{
+  NS_ASSERT (probe < N_PROBES);
+  return m_calls[probe];
+}
+
+uint64_t
+WifiProfiler::GetNanoSeconds (enum Probe probe)
+{
+  NS_ASSERT (probe < N_PROBES);
+  return m_nanoSeconds[probe];
+}
+
+const char *
+WifiProfiler::GetName (enum Probe probe)
+{
+  switch (probe)
+    {
+    case SEND_BASIC_TRIGGER:
+      return "MacLow::SendBasicTrigger";
+    case ENQUEUE_TO_HE_MPDU_LIST:
+      return "MacLow::EnqueueToHeMpduList";
+    case HE_CHANNEL_SEND:
+      return "HEWifiChannel::Send";
+    case INTERFERENCE_HELPER:
+      return "InterferenceHelper";
+    default:
+      NS_ASSERT (false);
+      return "";
+    }
+}
+
+WifiProfiler::Scope::Scope (enum Probe probe)
+  : m_probe (probe),
+    m_nested (m_enabled),
+    m_timed (false)
+{
+  if (m_nested)
+    {
+      //Only the outermost scope of a probe is timed
+      m_timed = (m_depth[probe]++ == 0);
+      if (m_timed)
+        {
+          m_start = std::chrono::steady_clock::now ();
+        }
+    }
+}
+
+WifiProfiler::Scope::~Scope ()
+{
+  if (m_timed)
+    {
+      std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - m_start;
+      m_nanoSeconds[m_probe] += std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+      m_calls[m_probe]++;
+    }
+  if (m_nested)
+    {
+      m_depth[m_probe]--;
+    }
+}
+
+} //namespace ns3
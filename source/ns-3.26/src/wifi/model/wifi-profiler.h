@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_PROFILER_H
+#define WIFI_PROFILER_H
+
+#include <stdint.h>
+#include <chrono>
+
+namespace ns3 {
+
+/**
+ * \brief wall clock time spent in the OFDMA hot paths of the wifi module
+ * \ingroup wifi
+ *
+ * The instrumented functions open a WifiProfiler::Scope on entry. While
+ * the profiler is disabled (the default), a scope only tests a flag. Once
+ * Enable has been called, each scope adds its wall clock duration and one
+ * call to the counters of its probe. Nested scopes of the same probe are
+ * only counted once.
+ *
+ * This is meant for benchmarks (see utils/bench-wifi-ofdma.cc), not for
+ * simulations: the counters are global to the process.
+ */
+class WifiProfiler
+{
+public:
+  /**
+   * The instrumented code paths.
+   */
+  enum Probe
+  {
+    SEND_BASIC_TRIGGER = 0,  //!< MacLow::SendBasicTrigger
+    ENQUEUE_TO_HE_MPDU_LIST, //!< MacLow::EnqueueToHeMpduList
+    HE_CHANNEL_SEND,         //!< HEWifiChannel::Send
+    INTERFERENCE_HELPER,     //!< public InterferenceHelper methods
+    N_PROBES
+  };
+
+  /**
+   * Start to account for the probes.
+   */
+  static void Enable (void);
+  /**
+   * Stop to account for the probes. The counters are kept.
+   */
+  static void Disable (void);
+  /**
+   * \return true if the probes are accounted for
+   */
+  static bool IsEnabled (void);
+  /**
+   * Reset the counters of all probes.
+   */
+  static void Reset (void);
+  /**
+   * \param probe the probe
+   *
+   * \return the number of calls accounted for the probe
+   */
+  static uint64_t GetCalls (enum Probe probe);
+  /**
+   * \param probe the probe
+   *
+   * \return the wall clock time spent in the probe, in nanoseconds
+   */
+  static uint64_t GetNanoSeconds (enum Probe probe);
+  /**
+   * \param probe the probe
+   *
+   * \return the name of the probe
+   */
+  static const char * GetName (enum Probe probe);
+
+  /**
+   * Accounts for the time spent between its construction and its
+   * destruction.
+   */
+  class Scope
+  {
+public:
+    /**
+     * \param probe the probe to account for
+     */
+    Scope (enum Probe probe);
+    ~Scope ();
+
+private:
+    enum Probe m_probe;                            //!< the probe
+    bool m_nested;                                 //!< whether this scope counts in the depth of the probe
+    bool m_timed;                                  //!< whether this scope is the outermost one of the probe
+    std::chrono::steady_clock::time_point m_start; //!< the construction time
+  };
+
+private:
+  static bool m_enabled;                  //!< whether the probes are accounted for
+  static uint32_t m_depth[N_PROBES];      //!< number of open scopes per probe
+  static uint64_t m_calls[N_PROBES];      //!< number of calls per probe
+  static uint64_t m_nanoSeconds[N_PROBES]; //!< time spent per probe
+};
+
+} //namespace ns3
+
+#endif /* WIFI_PROFILER_H */
@@ -397,6 +397,8 @@ WifiRemoteStationManager::DoDispose (void)
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
+  m_aidIndex.clear ();
 }
 
 void
@@ -424,7 +426,28 @@ WifiRemoteStationManager::SetupDcfManager (DcfManager *manager)
 void
 WifiRemoteStationManager::SetupAidQueue (uint16_t aid, Mac48Address mac, MacLowTransmissionListener *lt, enum AcIndex ac)
 {
+  SetStationAid (mac, aid);
+}
 
+void
+WifiRemoteStationManager::NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac)
+{
+}
+
+void
+WifiRemoteStationManager::SetStationAid (Mac48Address address, uint16_t aid)
+{
+  NS_LOG_FUNCTION (this << address << aid);
+  if (address.IsGroup ())
+    {
+      //The broadcast OFDMA queue of an AP has AID 0 but no station
+      return;
+    }
+  if (aid >= m_aidIndex.size ())
+    {
+      m_aidIndex.resize (aid + 1, Mac48Address::GetBroadcast ());
+    }
+  m_aidIndex[aid] = address;
 }
 
 void
@@ -1559,17 +1582,29 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
-WifiRemoteStationState *
-WifiRemoteStationManager::LookupState (Mac48Address address) const
+size_t
+WifiRemoteStationManager::Mac48AddressHash::operator () (const Mac48Address &address) const
 {
-  NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  //With a 32-bit size_t, only the last four bytes are kept: these are the
+  //ones that differ between the stations of a simulation
+  size_t hash = 0;
+  for (uint32_t i = 0; i < 6; i++)
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      hash = (hash << 8) | buffer[i];
+    }
+  return hash;
+}
+
+WifiRemoteStationManager::StationIndexEntry &
+WifiRemoteStationManager::LookupEntry (Mac48Address address) const
+{
+  StationIndex::iterator it = m_stationIndex.find (address);
+  if (it != m_stationIndex.end ())
+    {
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return it->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1590,8 +1625,28 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_isTxopLimitValid = false;
 
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  StationIndexEntry &entry = m_stationIndex[address];
+  entry.state = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
-  return state;
+  return entry;
+}
+
+WifiRemoteStationState *
+WifiRemoteStationManager::LookupState (Mac48Address address) const
+{
+  NS_LOG_FUNCTION (this << address);
+  return LookupEntry (address).state;
+}
+
+WifiRemoteStation *
+WifiRemoteStationManager::LookupByAid (uint16_t aid, uint8_t tid) const
+{
+  NS_LOG_FUNCTION (this << aid << (uint16_t)tid);
+  if (aid >= m_aidIndex.size () || m_aidIndex[aid].IsGroup ())
+    {
+      return 0;
+    }
+  return Lookup (m_aidIndex[aid], tid);
 }
 
 WifiRemoteStation *
@@ -1613,22 +1668,23 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << (uint16_t)tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  StationIndexEntry &entry = LookupEntry (address);
+  if (tid < entry.stations.size () && entry.stations[tid] != 0)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return entry.stations[tid];
     }
-  WifiRemoteStationState *state = LookupState (address);
 
   WifiRemoteStation *station = DoCreateStation ();
-  station->m_state = state;
+  station->m_state = entry.state;
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  if (tid >= entry.stations.size ())
+    {
+      entry.stations.resize (tid + 1, 0);
+    }
+  entry.stations[tid] = station;
   return station;
 }
 
@@ -1704,6 +1760,10 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_stations.clear ();
+  for (StationIndex::iterator i = m_stationIndex.begin (); i != m_stationIndex.end (); i++)
+    {
+      i->second.stations.clear ();
+    }
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear ();
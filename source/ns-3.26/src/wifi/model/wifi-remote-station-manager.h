@@ -36,6 +36,7 @@
 
 #include <vector>
 #include <utility>
+#include <unordered_map>
 #include "ns3/mac48-address.h"
 #include "ns3/traced-callback.h"
 #include "ns3/packet.h"
@@ -138,6 +139,22 @@ public:
    * Register a station queue with RRM Manager
    */
   virtual void SetupAidQueue (uint16_t aid, Mac48Address mac, MacLowTransmissionListener *lt, enum AcIndex ac);
+  /**
+   * Notify that the station queue registered with SetupAidQueue for this
+   * AID and access category has data to send.
+   *
+   * \param aid the AID of the station
+   * \param ac the access category of the queue
+   */
+  virtual void NotifyOfdmaAccessRequest (uint16_t aid, enum AcIndex ac);
+  /**
+   * Record the AID of an associated station, so that its state can be
+   * fetched by AID in constant time.
+   *
+   * \param address the address of the station
+   * \param aid the AID of the station
+   */
+  void SetStationAid (Mac48Address address, uint16_t aid);
   /**
    * Return the maximum STA short retry count (SSRC).
    *
@@ -976,6 +993,15 @@ protected:
    * \return WifiRemoteStation corresponding to the address
    */
   WifiRemoteStation* Lookup (Mac48Address address, uint8_t tid) const;
+  /**
+   * Return the station with the given AID and TID.
+   *
+   * \param aid the AID of the station
+   * \param tid the TID
+   * \return WifiRemoteStation of the station, or 0 if no station has been
+   *         given this AID with SetStationAid
+   */
+  WifiRemoteStation* LookupByAid (uint16_t aid, uint8_t tid) const;
 private:
   /**
    * \param station the station that we need to communicate
@@ -1237,6 +1263,34 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * Hash of a Mac48Address
+   */
+  struct Mac48AddressHash
+  {
+    size_t operator () (const Mac48Address &address) const;
+  };
+  /**
+   * The state of a known station and its WifiRemoteStations
+   */
+  struct StationIndexEntry
+  {
+    WifiRemoteStationState *state;              //!< State of the station
+    std::vector<WifiRemoteStation *> stations;  //!< Stations indexed by TID, 0 if not created yet
+  };
+  /**
+   * A hash table of the known stations indexed by address
+   */
+  typedef std::unordered_map <Mac48Address, StationIndexEntry, Mac48AddressHash> StationIndex;
+
+  /**
+   * Return the index entry of the given address, creating the state of
+   * the station if it is not known yet.
+   *
+   * \param address the address of the station
+   * \return the index entry of the station
+   */
+  StationIndexEntry & LookupEntry (Mac48Address address) const;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1269,6 +1323,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  mutable StationIndex m_stationIndex;     //!< States and stations indexed by address
+  std::vector<Mac48Address> m_aidIndex;    //!< Address of the station of each AID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -47,6 +47,7 @@ WifiTxVector::WifiTxVector ()
     m_stbc (false),
     m_ru (0xff),
     m_color(0),
+    m_padding (0),
     m_modeInitialized (false),
     m_txPowerLevelInitialized (false)
 {
@@ -66,6 +67,7 @@ WifiTxVector::WifiTxVector (WifiMode mode, uint8_t powerLevel, uint8_t retries,
     m_stbc (stbc),
     m_ru (0xff),
     m_color(0),
+    m_padding (0),
     m_modeInitialized (true),
     m_txPowerLevelInitialized (true)
 {
@@ -225,6 +227,18 @@ WifiTxVector::GetColor ()
   return m_color;
 }
 
+void
+WifiTxVector::SetPadding (uint32_t padding)
+{
+  m_padding = padding;
+}
+
+uint32_t
+WifiTxVector::GetPadding (void) const
+{
+  return m_padding;
+}
+
 std::ostream & operator << ( std::ostream &os, const WifiTxVector &v)
 {
   os << "mode: " << v.GetMode () <<
@@ -226,6 +226,18 @@ public:
   *
   */
   uint8_t GetColor ();
+  /**
+   * Sets the number of padding octets appended to the PSDU to align the
+   * end of an HE MU PPDU. The padding only extends the transmission
+   * duration; it is not carried in the packet buffer.
+   *
+   * \param padding the number of padding octets
+   */
+  void SetPadding (uint32_t padding);
+  /**
+   * \returns the number of padding octets appended to the PSDU
+   */
+  uint32_t GetPadding (void) const;
 
 private:
   WifiMode m_mode;               /**< The DATARATE parameter in Table 15-4.
@@ -245,6 +257,7 @@ private:
   uint8_t  m_ru;                 /**< Rosource Unit(RU) used for Transmission */
   uint16_t m_aid;                /**< AID to which TX happens */
   uint8_t  m_color;              /**< Color information for this BSS */
+  uint32_t m_padding;            /**< Padding octets at the end of the PSDU */
 
   bool     m_modeInitialized;         //*< Internal initialization flag */
   bool     m_txPowerLevelInitialized; //*< Internal initialization flag */
@@ -25,11 +25,15 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
@@ -51,11 +55,30 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("ReceiverCulling",
+                   "If true, a frame is only delivered to the PHYs within CullingRange of the sender "
+                   "and received above RxPowerFloor; the other PHYs get neither an event nor a copy. "
+                   "The PHYs are located through the CourseChange trace and the velocity of their "
+                   "mobility models, so models that move without reporting a velocity are not supported.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_receiverCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingRange",
+                   "The maximum distance (m) of a receiver when ReceiverCulling is enabled.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cullingRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("RxPowerFloor",
+                   "The minimum received power (dBm) of a delivered frame when ReceiverCulling is enabled.",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_rxPowerFloorDbm),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_receiverCulling (false)
 {
 }
 
@@ -83,46 +106,64 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  if (!m_receiverCulling)
     {
-      if (sender != (*i))
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
         {
-          //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
-
-          struct Parameters parameters;
-          parameters.rxPowerDbm = rxPowerDbm;
-          parameters.type = mpdutype;
-          parameters.duration = duration;
-          parameters.txVector = txVector;
-          parameters.preamble = preamble;
-
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, parameters);
+          SendToPhy (sender, senderMobility, j, packet, txPowerDbm, txVector, preamble, mpdutype, duration);
         }
+      return;
+    }
+  m_receiverGrid.GetPhysInRange (m_phyList, senderMobility->GetPosition (), m_cullingRange, m_receivers);
+  for (std::vector<uint32_t>::const_iterator r = m_receivers.begin (); r != m_receivers.end (); r++)
+    {
+      SendToPhy (sender, senderMobility, *r, packet, txPowerDbm, txVector, preamble, mpdutype, duration);
+    }
+}
+
+void
+YansWifiChannel::SendToPhy (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                            Ptr<const Packet> packet, double txPowerDbm,
+                            WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const
+{
+  Ptr<YansWifiPhy> receiver = m_phyList[j];
+  //For now don't account for inter channel interference
+  if (sender == receiver || receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
     }
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  if (m_receiverCulling && rxPowerDbm < m_rxPowerFloorDbm)
+    {
+      return;
+    }
+  Ptr<Packet> copy = packet->Copy ();
+  Ptr<Object> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+    }
+
+  struct Parameters parameters;
+  parameters.rxPowerDbm = rxPowerDbm;
+  parameters.type = mpdutype;
+  parameters.duration = duration;
+  parameters.txVector = txVector;
+  parameters.preamble = preamble;
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, copy, parameters);
 }
 
 void
@@ -30,10 +30,12 @@
 #include "wifi-tx-vector.h"
 #include "yans-wifi-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/position-grid.h"
 
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 
@@ -133,10 +135,32 @@ private:
    * \param preamble the type of preamble being used to send the packet
    */
   void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  /**
+   * Schedule the reception of a transmission by a PHY on the channel of
+   * the sender.
+   *
+   * \param sender the transmitting PHY
+   * \param senderMobility the mobility model of the transmitter
+   * \param j index of the receiving YansWifiPhy in the PHY list
+   * \param packet the packet being sent
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType
+   * \param duration the transmission duration associated to the packet
+   */
+  void SendToPhy (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                  Ptr<const Packet> packet, double txPowerDbm,
+                  WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  bool m_receiverCulling;              //!< Whether out-of-range receivers are skipped
+  double m_cullingRange;               //!< Maximum distance of a receiver in meters
+  double m_rxPowerFloorDbm;            //!< Minimum received power of a delivered frame
+  mutable PositionGrid m_receiverGrid; //!< Spatial index of the PHYs
+  mutable std::vector<uint32_t> m_receivers; //!< PHYs within CullingRange of the current sender
 };
 
 } //namespace ns3
@@ -0,0 +1,814 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/rrm-scheduler.h"
+#include "ns3/rrm-wifi-manager.h"
+#include "ns3/qos-utils.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/ap-wifi-mac.h"
+#include "ns3/edca-txop-n.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/HE-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/packet-socket-server.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace ns3;
+
+/**
+ * \param id the last byte of the MAC address of the station
+ * \param mcs the MCS reported for the station
+ * \return the statistics of a station without buffered data
+ */
+static AllStats_t
+MakeStats (uint8_t id, uint32_t mcs)
+{
+  AllStats_t s;
+  memset (&s, 0, sizeof (s));
+  s.macStr[MAC_ADDR_LEN - 1] = id;
+  s.mcsVal = mcs;
+  return s;
+}
+
+class UtilityRRMSchedulerMaxRateTest : public TestCase
+{
+public:
+  UtilityRRMSchedulerMaxRateTest ();
+  virtual ~UtilityRRMSchedulerMaxRateTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+UtilityRRMSchedulerMaxRateTest::UtilityRRMSchedulerMaxRateTest ()
+  : TestCase ("Check the RU partition and pairing of the MaxRate utility")
+{
+}
+
+UtilityRRMSchedulerMaxRateTest::~UtilityRRMSchedulerMaxRateTest ()
+{
+}
+
+void
+UtilityRRMSchedulerMaxRateTest::DoRun (void)
+{
+  Ptr<UtilityRRMScheduler> scheduler = CreateObject<UtilityRRMScheduler> ();
+  scheduler->SetAttribute ("Utility", EnumValue (UtilityRRMScheduler::MAX_RATE));
+  std::vector<uint32_t> bitMaps;
+  CreateObject<HEBitMap> ()->GetBitMap20 (bitMaps);
+
+  std::vector<AllStats_t> stats;
+  stats.push_back (MakeStats (1, 3));
+  stats.push_back (MakeStats (2, 7));
+  stats.push_back (MakeStats (3, 5));
+  stats[0].bufferDepthDL[AC_BE] = 1000;
+  stats[2].bufferDepthDL[AC_BK] = 1000;
+  stats[2].bufferDepthDL[AC_VI] = 1000;
+  std::vector<RRMClientResponse_t> results;
+
+  //The station with the highest MCS has no DL data; the next one gets the
+  //242-tone RU, which carries more than any split of the channel
+  scheduler->Schedule (true, stats, results);
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 1, "One station served on the whole channel");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].macStr[MAC_ADDR_LEN - 1], 3, "Highest MCS among backlogged stations");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].ruBitMap, bitMaps[15], "242-tone RU");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].mcsValue, 5, "MCS of the station");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].chanW, 20, "Width of a 242-tone RU");
+  NS_TEST_EXPECT_MSG_EQ (results[0].trafficType, AC_VI, "Highest priority backlogged AC");
+
+  //In UL, stations without a BSR are polled on best effort
+  scheduler->Schedule (false, stats, results);
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 1, "One station served on the whole channel");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].macStr[MAC_ADDR_LEN - 1], 2, "Highest MCS");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].mcsValue, 7, "MCS of the station");
+  NS_TEST_EXPECT_MSG_EQ (results[0].trafficType, AC_BE, "Best effort without BSR");
+}
+
+class UtilityRRMSchedulerDelayWeightedTest : public TestCase
+{
+public:
+  UtilityRRMSchedulerDelayWeightedTest ();
+  virtual ~UtilityRRMSchedulerDelayWeightedTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+UtilityRRMSchedulerDelayWeightedTest::UtilityRRMSchedulerDelayWeightedTest ()
+  : TestCase ("Check that the DelayWeighted utility ranks waiting VO traffic first")
+{
+}
+
+UtilityRRMSchedulerDelayWeightedTest::~UtilityRRMSchedulerDelayWeightedTest ()
+{
+}
+
+void
+UtilityRRMSchedulerDelayWeightedTest::DoRun (void)
+{
+  std::vector<AllStats_t> stats;
+  stats.push_back (MakeStats (1, 7));
+  stats.push_back (MakeStats (2, 2));
+  std::vector<RRMClientResponse_t> results;
+
+  //Station 1 has the highest MCS: a rate only ranking serves it first,
+  //whatever the waiting time of the VO traffic of station 2
+  Ptr<UtilityRRMScheduler> scheduler = CreateObject<UtilityRRMScheduler> ();
+  scheduler->SetAttribute ("Utility", EnumValue (UtilityRRMScheduler::MAX_RATE));
+  stats[0].bufferDepthDL[AC_BE] = 1000;
+  stats[1].bufferDepthDL[AC_VO] = 1000;
+  stats[1].WaitingTimeDL[AC_VO] = 60;
+  scheduler->Schedule (true, stats, results);
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 1, "One station served on the whole channel");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].macStr[MAC_ADDR_LEN - 1], 1, "Highest MCS first");
+
+  //Station 2 is first served alone on the 242-tone RU, which raises its
+  //average rate (averaged over two rounds) to about 5.4 times its 26-tone
+  //RU rate. A new station is weighted by the inverse of its 26-tone RU
+  //rate, so station 2 then needs a VO waiting time above about 44 ms
+  //(4.4 times the DelayScale) to be served before station 1.
+  double waitingTime[] = {10, 60};
+  uint32_t expectedFirst[] = {1, 2};
+  int expectedAc[] = {AC_BE, AC_VO};
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      scheduler = CreateObject<UtilityRRMScheduler> ();
+      scheduler->SetAttribute ("Utility", EnumValue (UtilityRRMScheduler::DELAY_WEIGHTED));
+      scheduler->SetAttribute ("DelayScale", DoubleValue (10.0));
+      scheduler->SetAttribute ("AveragingRounds", DoubleValue (2.0));
+      stats[0].bufferDepthDL[AC_BE] = 0;
+      stats[1].bufferDepthDL[AC_VO] = 0;
+      stats[1].bufferDepthDL[AC_BE] = 1000;
+      scheduler->Schedule (true, stats, results);
+      NS_TEST_ASSERT_MSG_EQ (results.size (), 1, "Station 2 served alone");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].chanW, 20, "242-tone RU");
+
+      stats[0].bufferDepthDL[AC_BE] = 1000;
+      stats[1].bufferDepthDL[AC_VO] = 1000;
+      stats[1].WaitingTimeDL[AC_VO] = waitingTime[k];
+      scheduler->Schedule (true, stats, results);
+      NS_TEST_ASSERT_MSG_GT (results.size (), 0, "Stations served");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].macStr[MAC_ADDR_LEN - 1], expectedFirst[k], "Station on the largest RU, waiting time " << waitingTime[k]);
+      NS_TEST_EXPECT_MSG_EQ (results[0].trafficType, expectedAc[k], "AC on the largest RU, waiting time " << waitingTime[k]);
+    }
+}
+
+class RoundRobinRRMSchedulerTest : public TestCase
+{
+public:
+  RoundRobinRRMSchedulerTest ();
+  virtual ~RoundRobinRRMSchedulerTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RoundRobinRRMSchedulerTest::RoundRobinRRMSchedulerTest ()
+  : TestCase ("Check the rotation and RU allocation of the round robin scheduler")
+{
+}
+
+RoundRobinRRMSchedulerTest::~RoundRobinRRMSchedulerTest ()
+{
+}
+
+void
+RoundRobinRRMSchedulerTest::DoRun (void)
+{
+  Ptr<RoundRobinRRMScheduler> scheduler = CreateObject<RoundRobinRRMScheduler> ();
+  std::vector<uint32_t> bitMaps;
+  CreateObject<HEBitMap> ()->GetBitMap20 (bitMaps);
+
+  std::vector<AllStats_t> stats;
+  stats.push_back (MakeStats (1, 3));
+  stats.push_back (MakeStats (2, 7));
+  stats.push_back (MakeStats (3, 5));
+  stats[0].bufferDepthDL[AC_BK] = 1000;
+  stats[2].bufferDepthDL[AC_BE] = 1000;
+  stats[2].bufferDepthDL[AC_VO] = 1000;
+  stats[1].bufferDepthUL[AC_VI] = 1000;
+  std::vector<RRMClientResponse_t> results;
+
+  //The round starts after the first station, station 2 has no DL data
+  scheduler->Schedule (true, stats, results);
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 2, "Two stations with DL data");
+  uint32_t expectedId[] = {3, 1};
+  uint32_t expectedMcs[] = {5, 3};
+  int expectedAc[] = {AC_VO, AC_BK};
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[k].macStr[MAC_ADDR_LEN - 1], expectedId[k], "Station of RU " << k);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[k].ruBitMap, bitMaps[k], "26-tone RU " << k);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[k].mcsValue, expectedMcs[k], "MCS on RU " << k);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[k].chanW, 2, "Width of a 26-tone RU");
+      NS_TEST_EXPECT_MSG_EQ (results[k].trafficType, expectedAc[k], "AC on RU " << k);
+    }
+
+  //With one station per round, the stations with DL data take turns
+  scheduler->SetAttribute ("StationsPerRound", UintegerValue (1));
+  uint32_t expectedTurn[] = {3, 1, 3};
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      scheduler->Schedule (true, stats, results);
+      NS_TEST_ASSERT_MSG_EQ (results.size (), 1, "One station per round");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].macStr[MAC_ADDR_LEN - 1], expectedTurn[k], "Station of round " << k);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[0].ruBitMap, bitMaps[0], "First 26-tone RU");
+    }
+
+  //UL rounds poll every station, on best effort without a BSR, and keep
+  //their own cursor
+  scheduler->SetAttribute ("StationsPerRound", UintegerValue (9));
+  scheduler->Schedule (false, stats, results);
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 3, "All stations polled");
+  uint32_t expectedUlId[] = {2, 3, 1};
+  int expectedUlAc[] = {AC_VI, AC_BE, AC_BE};
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)results[k].macStr[MAC_ADDR_LEN - 1], expectedUlId[k], "Station of RU " << k);
+      NS_TEST_EXPECT_MSG_EQ (results[k].trafficType, expectedUlAc[k], "AC on RU " << k);
+    }
+
+  stats.clear ();
+  scheduler->Schedule (true, stats, results);
+  NS_TEST_EXPECT_MSG_EQ (results.size (), 0, "No station");
+}
+
+/**
+ * Round robin scheduler that counts the rounds it is asked to schedule.
+ */
+class CountingRRMScheduler : public RoundRobinRRMScheduler
+{
+public:
+  CountingRRMScheduler ();
+  virtual void Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                         std::vector<RRMClientResponse_t> &results);
+
+  uint32_t m_dlRounds; //!< number of DL rounds with at least one station served
+  uint32_t m_ulRounds; //!< number of UL rounds
+};
+
+CountingRRMScheduler::CountingRRMScheduler ()
+  : m_dlRounds (0),
+    m_ulRounds (0)
+{
+}
+
+void
+CountingRRMScheduler::Schedule (bool isDownlink, const std::vector<AllStats_t> &stats,
+                                std::vector<RRMClientResponse_t> &results)
+{
+  RoundRobinRRMScheduler::Schedule (isDownlink, stats, results);
+  if (!isDownlink)
+    {
+      m_ulRounds++;
+    }
+  else if (!results.empty ())
+    {
+      m_dlRounds++;
+    }
+}
+
+/**
+ * Build an AP (node 0) using RRMWifiManager and one associated HE
+ * station (node 1), with a DL flow from the AP to the station starting
+ * at 1 s, one packet every 10 ms.
+ *
+ * \param scheduler the Scheduler attribute of the AP station manager
+ * \param external the ExternalScheduler attribute of the AP station manager
+ * \param rx the callback invoked for each packet received by the station
+ * \param maxPackets the number of packets of the DL flow
+ * \return the station manager of the AP
+ */
+static Ptr<WifiRemoteStationManager>
+SetupRRMBss (Ptr<RRMScheduler> scheduler, bool external,
+             Callback<void, Ptr<const Packet>, const Address &> rx,
+             uint32_t maxPackets = 20)
+{
+  NodeContainer apNode;
+  NodeContainer staNode;
+  apNode.Create (1);
+  staNode.Create (1);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_2_4GHZ);
+  HEWifiChannelHelper wifiChannel = HEWifiChannelHelper::Default ();
+  HEWifiPhyHelper wifiPhy = HEWifiPhyHelper::Default ();
+  wifiPhy.SetErrorRateModel ("ns3::YansErrorRateModel");
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  Ssid ssid = Ssid ("rrm-scheduler");
+  WifiMacHelper wifiMac;
+
+  wifiMac.SetType ("ns3::ApWifiMac",
+                   "Ssid", SsidValue (ssid));
+  wifi.SetRemoteStationManager ("ns3::RRMWifiManager",
+                                "DataMode", StringValue ("HeMcs0"),
+                                "ControlMode", StringValue ("HeMcs0"),
+                                "NonUnicastMode", StringValue ("HeMcs0"),
+                                "RtsCtsThreshold", UintegerValue (2200),
+                                "FragmentationThreshold", UintegerValue (2200),
+                                "SchedulerPlugin", BooleanValue (true),
+                                "Scheduler", PointerValue (scheduler),
+                                "ExternalScheduler", BooleanValue (external));
+  NetDeviceContainer apDevice = wifi.Install (wifiPhy, wifiMac, apNode);
+
+  wifiMac.SetType ("ns3::StaWifiMac",
+                   "Ssid", SsidValue (ssid));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HeMcs0"),
+                                "ControlMode", StringValue ("HeMcs0"),
+                                "NonUnicastMode", StringValue ("HeMcs0"),
+                                "RtsCtsThreshold", UintegerValue (2200),
+                                "FragmentationThreshold", UintegerValue (2200));
+  NetDeviceContainer staDevice = wifi.Install (wifiPhy, wifiMac, staNode);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNode);
+
+  PacketSocketAddress socket;
+  socket.SetSingleDevice (apDevice.Get (0)->GetIfIndex ());
+  socket.SetPhysicalAddress (staDevice.Get (0)->GetAddress ());
+  socket.SetProtocol (1);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (apNode);
+  packetSocket.Install (staNode);
+
+  Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+  client->SetAttribute ("PacketSize", UintegerValue (500));
+  client->SetAttribute ("MaxPackets", UintegerValue (maxPackets));
+  client->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  client->SetRemote (socket);
+  apNode.Get (0)->AddApplication (client);
+  client->SetStartTime (Seconds (1));
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (socket);
+  staNode.Get (0)->AddApplication (server);
+  server->TraceConnectWithoutContext ("Rx", rx);
+
+  return DynamicCast<WifiNetDevice> (apDevice.Get (0))->GetRemoteStationManager ();
+}
+
+class RRMWifiManagerSchedulerTest : public TestCase
+{
+public:
+  RRMWifiManagerSchedulerTest ();
+  virtual ~RRMWifiManagerSchedulerTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param p the packet received by the station
+   * \param from the address of the sender
+   */
+  void Receive (Ptr<const Packet> p, const Address &from);
+
+  uint32_t m_received; //!< number of packets received by the station
+};
+
+RRMWifiManagerSchedulerTest::RRMWifiManagerSchedulerTest ()
+  : TestCase ("Check that RRMWifiManager schedules through its Scheduler attribute")
+{
+}
+
+RRMWifiManagerSchedulerTest::~RRMWifiManagerSchedulerTest ()
+{
+}
+
+void
+RRMWifiManagerSchedulerTest::Receive (Ptr<const Packet> p, const Address &from)
+{
+  m_received++;
+}
+
+void
+RRMWifiManagerSchedulerTest::DoRun (void)
+{
+  //A scheduler set through the attribute serves the DL flow
+  Ptr<CountingRRMScheduler> scheduler = CreateObject<CountingRRMScheduler> ();
+  m_received = 0;
+  Ptr<WifiRemoteStationManager> manager = SetupRRMBss (scheduler, false, MakeCallback (&RRMWifiManagerSchedulerTest::Receive, this));
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  PointerValue ptr;
+  manager->GetAttribute ("Scheduler", ptr);
+  NS_TEST_EXPECT_MSG_EQ (ptr.Get<RRMScheduler> (), scheduler, "Scheduler attribute kept");
+  NS_TEST_EXPECT_MSG_GT (scheduler->m_dlRounds, 0, "DL rounds scheduled by the plugin");
+  NS_TEST_EXPECT_MSG_GT (scheduler->m_ulRounds, 0, "UL rounds scheduled by the plugin");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 20, "DL flow delivered");
+  Simulator::Destroy ();
+
+  //Without a scheduler, a round robin scheduler is created at initialization
+  m_received = 0;
+  manager = SetupRRMBss (0, false, MakeCallback (&RRMWifiManagerSchedulerTest::Receive, this));
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  manager->GetAttribute ("Scheduler", ptr);
+  NS_TEST_EXPECT_MSG_NE (DynamicCast<RoundRobinRRMScheduler> (ptr.Get<RRMScheduler> ()), 0, "Default scheduler");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 20, "DL flow delivered");
+  Simulator::Destroy ();
+
+  //The external server is used instead of the in-process scheduler; without
+  //a server, rounds fall back to the sample schedulers
+  scheduler = CreateObject<CountingRRMScheduler> ();
+  m_received = 0;
+  manager = SetupRRMBss (scheduler, true, MakeCallback (&RRMWifiManagerSchedulerTest::Receive, this));
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (scheduler->m_dlRounds + scheduler->m_ulRounds, 0, "In-process scheduler unused");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 20, "DL flow delivered");
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a station whose DL queue was found empty by the sample
+ * scheduler is scheduled again once the queue is refilled through
+ * PushFront, as a retransmission or an ADDBA response would.
+ */
+class RRMWifiManagerRefillTest : public TestCase
+{
+public:
+  RRMWifiManagerRefillTest ();
+  virtual ~RRMWifiManagerRefillTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param p the packet received by the station
+   * \param from the address of the sender
+   */
+  void Receive (Ptr<const Packet> p, const Address &from);
+  /**
+   * Put a data packet for the station at the head of its best effort
+   * OFDMA queue.
+   *
+   * \param ap the MAC of the AP
+   * \param sta the address of the station
+   */
+  void PushFront (Ptr<ApWifiMac> ap, Mac48Address sta);
+
+  uint32_t m_received; //!< number of packets received by the station
+};
+
+RRMWifiManagerRefillTest::RRMWifiManagerRefillTest ()
+  : TestCase ("Check that the sample DL scheduler serves a queue refilled through PushFront")
+{
+}
+
+RRMWifiManagerRefillTest::~RRMWifiManagerRefillTest ()
+{
+}
+
+void
+RRMWifiManagerRefillTest::Receive (Ptr<const Packet> p, const Address &from)
+{
+  m_received++;
+}
+
+void
+RRMWifiManagerRefillTest::PushFront (Ptr<ApWifiMac> ap, Mac48Address sta)
+{
+  Ptr<EdcaTxopN> queue = ap->GetStationQueue (sta, AC_BE);
+  NS_TEST_ASSERT_MSG_NE (queue, 0, "OFDMA queue of the station");
+  NS_TEST_ASSERT_MSG_EQ (queue->NeedsAccess (), false, "Queue emptied");
+  Ptr<Packet> packet = Create<Packet> (500);
+  LlcSnapHeader llc;
+  llc.SetType (1);
+  packet->AddHeader (llc);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
+  hdr.SetQosNoEosp ();
+  hdr.SetQosNoAmsdu ();
+  hdr.SetQosTxopLimit (0);
+  hdr.SetQosTid (0);
+  hdr.SetNoOrder ();
+  hdr.SetAddr1 (sta);
+  hdr.SetAddr2 (ap->GetAddress ());
+  hdr.SetAddr3 (ap->GetAddress ());
+  hdr.SetDsFrom ();
+  hdr.SetDsNotTo ();
+  queue->PushFront (packet, hdr);
+}
+
+void
+RRMWifiManagerRefillTest::DoRun (void)
+{
+  //Without a server, the external scheduler falls back to the sample
+  //schedulers. The queue of the station is found empty once the single
+  //packet of the flow is delivered, and is refilled half a second later.
+  m_received = 0;
+  SetupRRMBss (0, true, MakeCallback (&RRMWifiManagerRefillTest::Receive, this), 1);
+  Ptr<ApWifiMac> ap = DynamicCast<ApWifiMac> (DynamicCast<WifiNetDevice> (NodeList::GetNode (0)->GetDevice (0))->GetMac ());
+  Mac48Address sta = Mac48Address::ConvertFrom (NodeList::GetNode (1)->GetDevice (0)->GetAddress ());
+  Simulator::Schedule (Seconds (1.5), &RRMWifiManagerRefillTest::PushFront, this, ap, sta);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "Flow and refilled packet delivered");
+}
+
+/**
+ * Minimal RRM server of the batched protocol, listening on the loopback
+ * interface. Each station of a DL snapshot with buffered data is given a
+ * 26-tone RU; each station of an UL snapshot is polled on best effort.
+ * The results are written one byte at a time, after the results of an
+ * epoch that was never requested, to check that the RRMWifiManager
+ * reassembles the frames and discards the unknown epochs.
+ */
+class BatchedRRMServer
+{
+public:
+  BatchedRRMServer ();
+  /**
+   * \return true if the server listens on the RRM server port
+   */
+  bool Listen (void);
+  /**
+   * Serve one connection until it is closed or Stop is called.
+   */
+  void Run (void);
+  /**
+   * Stop the server.
+   */
+  void Stop (void);
+
+  uint32_t m_epochs; //!< number of snapshots answered
+  uint32_t m_errors; //!< number of malformed snapshots
+
+private:
+  /**
+   * \param buf the buffer to fill
+   * \param len the number of bytes to read
+   * \return true if len bytes have been read
+   */
+  bool Read (void *buf, size_t len);
+  /**
+   * \param epoch the epoch of the results
+   * \param isDownlink the direction of the results
+   * \param results the results to write
+   */
+  void WriteResults (uint32_t epoch, uint8_t isDownlink,
+                     const std::vector<RRMClientResponse_t> &results);
+
+  int m_listenFd; //!< listening socket
+  int m_fd;       //!< socket of the connection with the RRMWifiManager
+};
+
+BatchedRRMServer::BatchedRRMServer ()
+  : m_epochs (0),
+    m_errors (0),
+    m_listenFd (-1),
+    m_fd (-1)
+{
+}
+
+bool
+BatchedRRMServer::Listen (void)
+{
+  struct sockaddr_in addr;
+  int reuse = 1;
+  m_listenFd = socket (AF_INET, SOCK_STREAM, 0);
+  setsockopt (m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse));
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  addr.sin_port = htons (PORTNUM);
+  return bind (m_listenFd, (struct sockaddr *)&addr, sizeof (addr)) == 0
+         && listen (m_listenFd, 1) == 0;
+}
+
+bool
+BatchedRRMServer::Read (void *buf, size_t len)
+{
+  size_t done = 0;
+  while (done < len)
+    {
+      ssize_t ret = recv (m_fd, (uint8_t *)buf + done, len - done, 0);
+      if (ret <= 0)
+        {
+          return false;
+        }
+      done += ret;
+    }
+  return true;
+}
+
+void
+BatchedRRMServer::WriteResults (uint32_t epoch, uint8_t isDownlink,
+                                const std::vector<RRMClientResponse_t> &results)
+{
+  TlvBatchHeader_t header;
+  header.type = htons (TYPE_11AX_BATCH_RESULTS_RESP);
+  header.count = htons (results.size ());
+  header.epoch = htonl (epoch);
+  header.isDownlink = isDownlink;
+  header.frameLen = htonl (results.size () * sizeof (RRMClientResponse_t));
+  std::vector<uint8_t> frame (sizeof (header) + results.size () * sizeof (RRMClientResponse_t));
+  memcpy (frame.data (), &header, sizeof (header));
+  if (!results.empty ())
+    {
+      memcpy (frame.data () + sizeof (header), results.data (), results.size () * sizeof (RRMClientResponse_t));
+    }
+  for (uint32_t i = 0; i < frame.size (); i++)
+    {
+      if (send (m_fd, frame.data () + i, 1, MSG_NOSIGNAL) != 1)
+        {
+          return;
+        }
+    }
+}
+
+void
+BatchedRRMServer::Run (void)
+{
+  m_fd = accept (m_listenFd, 0, 0);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  //Send each byte of the results in its own segment
+  int noDelay = 1;
+  setsockopt (m_fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof (noDelay));
+  std::vector<uint32_t> bitMaps;
+  CreateObject<HEBitMap> ()->GetBitMap20 (bitMaps);
+  TlvBatchHeader_t header;
+  while (Read (&header, sizeof (header)))
+    {
+      uint32_t count = ntohs (header.count);
+      uint32_t frameLen = ntohl (header.frameLen);
+      if (ntohs (header.type) != TYPE_11AX_BATCH_STATS_REQ
+          || frameLen != count * sizeof (AllStats_t)
+          || ntohl (header.epoch) != m_epochs)
+        {
+          m_errors++;
+        }
+      std::vector<AllStats_t> stats (count);
+      if (!Read (stats.data (), frameLen))
+        {
+          break;
+        }
+      std::vector<RRMClientResponse_t> results;
+      for (uint32_t i = 0; i < count && results.size () < 9; i++)
+        {
+          int ac = AC_BE;
+          if (header.isDownlink)
+            {
+              int depth[4];
+              memcpy (depth, stats[i].bufferDepthDL, sizeof (depth));
+              for (ac = AC_BE_NQOS - 1; ac >= 0 && depth[ac] == 0; ac--)
+                {
+                }
+              if (ac < 0)
+                {
+                  continue;
+                }
+            }
+          RRMClientResponse_t resp;
+          memset (&resp, 0, sizeof (resp));
+          memcpy (resp.macStr, stats[i].macStr, MAC_ADDR_LEN);
+          resp.trafficType = ac;
+          resp.ruBitMap = bitMaps[results.size ()];
+          resp.mcsValue = stats[i].mcsVal;
+          resp.chanW = 2;
+          results.push_back (resp);
+        }
+      if (m_epochs == 0)
+        {
+          WriteResults (0xffffffff, header.isDownlink, results);
+        }
+      WriteResults (ntohl (header.epoch), header.isDownlink, results);
+      m_epochs++;
+    }
+}
+
+void
+BatchedRRMServer::Stop (void)
+{
+  if (m_fd >= 0)
+    {
+      shutdown (m_fd, SHUT_RDWR);
+    }
+  shutdown (m_listenFd, SHUT_RDWR);
+  close (m_listenFd);
+}
+
+class RRMWifiManagerBatchedProtocolTest : public TestCase
+{
+public:
+  RRMWifiManagerBatchedProtocolTest ();
+  virtual ~RRMWifiManagerBatchedProtocolTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param p the packet received by the station
+   * \param from the address of the sender
+   */
+  void Receive (Ptr<const Packet> p, const Address &from);
+
+  uint32_t m_received; //!< number of packets received by the station
+};
+
+RRMWifiManagerBatchedProtocolTest::RRMWifiManagerBatchedProtocolTest ()
+  : TestCase ("Check the batched RRM server protocol over the loopback interface")
+{
+}
+
+RRMWifiManagerBatchedProtocolTest::~RRMWifiManagerBatchedProtocolTest ()
+{
+}
+
+void
+RRMWifiManagerBatchedProtocolTest::Receive (Ptr<const Packet> p, const Address &from)
+{
+  m_received++;
+}
+
+void
+RRMWifiManagerBatchedProtocolTest::DoRun (void)
+{
+  BatchedRRMServer server;
+  NS_TEST_ASSERT_MSG_EQ (server.Listen (), true, "RRM server port " << PORTNUM << " in use");
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&BatchedRRMServer::Run, &server));
+  thread->Start ();
+
+  m_received = 0;
+  Ptr<WifiRemoteStationManager> manager = SetupRRMBss (0, true, MakeCallback (&RRMWifiManagerBatchedProtocolTest::Receive, this));
+  manager->SetAttribute ("BatchedProtocol", BooleanValue (true));
+  //A round that misses its results waits for the whole timeout
+  manager->SetAttribute ("ServerTimeout", TimeValue (Seconds (5)));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  int64_t wall = clock.End ();
+  server.Stop ();
+  thread->Join ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_GT (server.m_epochs, 0, "Epochs answered by the RRM server");
+  NS_TEST_EXPECT_MSG_EQ (server.m_errors, 0, "Consecutive, well-formed snapshots");
+  NS_TEST_EXPECT_MSG_LT (wall, 5000, "No round waited for the server timeout");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 20, "DL flow delivered");
+}
+
+class RRMSchedulerTestSuite : public TestSuite
+{
+public:
+  RRMSchedulerTestSuite ();
+};
+
+RRMSchedulerTestSuite::RRMSchedulerTestSuite ()
+  : TestSuite ("wifi-rrm-scheduler", UNIT)
+{
+  AddTestCase (new RoundRobinRRMSchedulerTest, TestCase::QUICK);
+  AddTestCase (new UtilityRRMSchedulerMaxRateTest, TestCase::QUICK);
+  AddTestCase (new UtilityRRMSchedulerDelayWeightedTest, TestCase::QUICK);
+  AddTestCase (new RRMWifiManagerSchedulerTest, TestCase::QUICK);
+  AddTestCase (new RRMWifiManagerRefillTest, TestCase::QUICK);
+  AddTestCase (new RRMWifiManagerBatchedProtocolTest, TestCase::QUICK);
+}
+
+static RRMSchedulerTestSuite rrmSchedulerTestSuite;
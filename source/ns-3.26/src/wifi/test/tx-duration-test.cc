@@ -333,6 +333,152 @@ TxDurationTest::DoRun (void)
 }
 
 
+/**
+ * Check that the HE MU padding carried in the TXVECTOR gives the on-air
+ * durations of the padding octets that used to be appended to the PSDU.
+ */
+class TxDurationPaddingTest : public TestCase
+{
+public:
+  TxDurationPaddingTest ();
+  virtual ~TxDurationPaddingTest ();
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Check the duration of a single MPDU with padding against the one of
+   * the MPDU extended by the padding octets.
+   *
+   * @param size size of the MPDU in octets
+   * @param padding padding octets
+   * @param payloadMode the WifiMode used
+   * @param preamble the WifiPreamble used
+   */
+  void CheckSingleMpdu (uint32_t size, uint32_t padding, WifiMode payloadMode, WifiPreamble preamble);
+  /**
+   * Check the duration of an A-MPDU with padding against the one of the
+   * A-MPDU whose last MPDU is extended by the padding octets.
+   *
+   * @param sizes size of each MPDU of the A-MPDU in octets
+   * @param padding padding octets
+   * @param payloadMode the WifiMode used
+   * @param preamble the WifiPreamble used
+   */
+  void CheckAmpdu (std::vector<uint32_t> sizes, uint32_t padding, WifiMode payloadMode, WifiPreamble preamble);
+  /**
+   * @param payloadMode the WifiMode used
+   * @param padding padding octets
+   *
+   * @return a 20 MHz TXVECTOR
+   */
+  WifiTxVector GetTxVector (WifiMode payloadMode, uint32_t padding) const;
+
+  Ptr<YansWifiPhy> m_phy; //!< PHY computing the durations
+};
+
+TxDurationPaddingTest::TxDurationPaddingTest ()
+  : TestCase ("Wifi TX Duration with HE MU padding")
+{
+}
+
+TxDurationPaddingTest::~TxDurationPaddingTest ()
+{
+}
+
+WifiTxVector
+TxDurationPaddingTest::GetTxVector (WifiMode payloadMode, uint32_t padding) const
+{
+  WifiTxVector txVector;
+  txVector.SetMode (payloadMode);
+  txVector.SetChannelWidth (20);
+  txVector.SetShortGuardInterval (false);
+  txVector.SetNss (1);
+  txVector.SetStbc (0);
+  txVector.SetNess (0);
+  txVector.SetPadding (padding);
+  return txVector;
+}
+
+void
+TxDurationPaddingTest::CheckSingleMpdu (uint32_t size, uint32_t padding, WifiMode payloadMode, WifiPreamble preamble)
+{
+  //The unpadded duration of the same size is computed first, so that a
+  //cache ignoring the padding would return it
+  Time unpadded = m_phy->CalculateTxDuration (size, GetTxVector (payloadMode, 0), preamble, CHANNEL_36_MHZ);
+  Time padded = m_phy->CalculateTxDuration (size, GetTxVector (payloadMode, padding), preamble, CHANNEL_36_MHZ);
+  Time expected = m_phy->CalculateTxDuration (size + padding, GetTxVector (payloadMode, 0), preamble, CHANNEL_36_MHZ);
+  NS_TEST_EXPECT_MSG_EQ (padded, expected, payloadMode << " MPDU of " << size << " octets with " << padding << " octets of padding");
+  NS_TEST_EXPECT_MSG_EQ ((padded >= unpadded), true, "Padding shortens the MPDU");
+
+  std::vector<uint32_t> sizes (1, size);
+  std::vector<WifiTxVector> txVectors (1, GetTxVector (payloadMode, padding));
+  std::vector<Time> durations;
+  m_phy->CalculateTxDurations (sizes, txVectors, preamble, CHANNEL_36_MHZ, durations);
+  NS_TEST_EXPECT_MSG_EQ (durations[0], expected, payloadMode << " MU PSDU of " << size << " octets with " << padding << " octets of padding");
+}
+
+void
+TxDurationPaddingTest::CheckAmpdu (std::vector<uint32_t> sizes, uint32_t padding, WifiMode payloadMode, WifiPreamble preamble)
+{
+  Time padded = Seconds (0);
+  Time expected = Seconds (0);
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      WifiTxVector txVector = GetTxVector (payloadMode, k == 0 ? padding : 0);
+      Time total = Seconds (0);
+      for (uint32_t i = 0; i < sizes.size (); i++)
+        {
+          bool last = (i == sizes.size () - 1);
+          uint32_t size = sizes[i];
+          if (last && k == 1)
+            {
+              size += padding;
+            }
+          total += m_phy->CalculateTxDuration (size, txVector, i == 0 ? preamble : WIFI_PREAMBLE_NONE, CHANNEL_36_MHZ,
+                                               last ? LAST_MPDU_IN_AGGREGATE : MPDU_IN_AGGREGATE, 1);
+        }
+      if (k == 0)
+        {
+          padded = total;
+        }
+      else
+        {
+          expected = total;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (padded, expected, payloadMode << " A-MPDU of " << sizes.size () << " MPDUs with " << padding << " octets of padding");
+}
+
+void
+TxDurationPaddingTest::DoRun (void)
+{
+  m_phy = CreateObject<YansWifiPhy> ();
+
+  CheckSingleMpdu (100, 1, WifiPhy::GetHeMcs0 (), WIFI_PREAMBLE_HE);
+  CheckSingleMpdu (100, 300, WifiPhy::GetHeMcs0 (), WIFI_PREAMBLE_HE);
+  CheckSingleMpdu (1536, 7, WifiPhy::GetHeMcs7 (), WIFI_PREAMBLE_HE);
+  CheckSingleMpdu (1536, 2000, WifiPhy::GetHeMcs7 (), WIFI_PREAMBLE_HE);
+  //VHT rates round the A-MPDU to whole symbols, which the padding of the
+  //last MPDU must carry over
+  CheckSingleMpdu (76, 5, WifiPhy::GetVhtMcs8 (), WIFI_PREAMBLE_VHT);
+  CheckSingleMpdu (1536, 333, WifiPhy::GetVhtMcs8 (), WIFI_PREAMBLE_VHT);
+
+  std::vector<uint32_t> sizes;
+  sizes.push_back (1538);
+  sizes.push_back (1538);
+  sizes.push_back (802);
+  CheckAmpdu (sizes, 13, WifiPhy::GetHeMcs5 (), WIFI_PREAMBLE_HE);
+  CheckAmpdu (sizes, 1000, WifiPhy::GetHeMcs5 (), WIFI_PREAMBLE_HE);
+  CheckAmpdu (sizes, 13, WifiPhy::GetVhtMcs8 (), WIFI_PREAMBLE_VHT);
+  CheckAmpdu (sizes, 1000, WifiPhy::GetVhtMcs8 (), WIFI_PREAMBLE_VHT);
+  sizes.resize (2);
+  CheckAmpdu (sizes, 57, WifiPhy::GetVhtMcs3 (), WIFI_PREAMBLE_VHT);
+
+  m_phy = 0;
+}
+
+
 class TxDurationTestSuite : public TestSuite
 {
 public:
@@ -343,6 +489,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationPaddingTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite;
@@ -23,6 +23,12 @@
 #include "ns3/dsss-error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/he-link-abstraction.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
 
 using namespace ns3;
 
@@ -279,6 +285,168 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+class WifiErrorRateModelsTestCaseTable : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTable ();
+  virtual ~WifiErrorRateModelsTestCaseTable ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseTable::WifiErrorRateModelsTestCaseTable ()
+  : TestCase ("WifiErrorRateModel test case table")
+{
+}
+
+WifiErrorRateModelsTestCaseTable::~WifiErrorRateModelsTestCaseTable ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTable::DoRun (void)
+{
+  uint32_t FrameSize = 2000;
+  WifiTxVector txVector;
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  const char *modes[] = {"OfdmRate6Mbps", "OfdmRate9Mbps", "OfdmRate12Mbps", "OfdmRate18Mbps",
+                         "OfdmRate24Mbps", "OfdmRate36Mbps", "OfdmRate48Mbps", "OfdmRate54Mbps"};
+
+  // The table must reproduce the NIST model between and on its grid points
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      WifiMode mode (modes[m]);
+      for (double snr = 0.0; snr < 30.0; snr += 0.0123)
+        {
+          double linear = std::pow (10.0, snr / 10.0);
+          double expected = nist->GetChunkSuccessRate (mode, txVector, linear, FrameSize * 8);
+          double ps = table->GetChunkSuccessRate (mode, txVector, linear, FrameSize * 8);
+          NS_TEST_ASSERT_MSG_EQ_TOL (ps, expected, 1e-4, "Not equal within tolerance for " << mode << " at " << snr << " dB");
+        }
+    }
+}
+
+class WifiErrorRateModelsTestCaseTableYans : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTableYans ();
+  virtual ~WifiErrorRateModelsTestCaseTableYans ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseTableYans::WifiErrorRateModelsTestCaseTableYans ()
+  : TestCase ("WifiErrorRateModel test case table of the Yans model with HE rates")
+{
+}
+
+WifiErrorRateModelsTestCaseTableYans::~WifiErrorRateModelsTestCaseTableYans ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTableYans::DoRun (void)
+{
+  uint32_t FrameSize = 2000;
+  Ptr<YansErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (yans));
+  WifiMode modes[] = {WifiPhy::GetHeMcs0 (), WifiPhy::GetHeMcs3 (), WifiPhy::GetHeMcs5 (), WifiPhy::GetHeMcs7 ()};
+  uint32_t widths[] = {20, 40, 80};
+
+  // The Yans BER depends on the channel width, guard interval and number
+  // of streams: each mode is queried with all of them, in turn
+  for (uint32_t w = 0; w < sizeof (widths) / sizeof (widths[0]); w++)
+    {
+      for (uint8_t nss = 1; nss <= 2; nss++)
+        {
+          for (uint32_t sgi = 0; sgi < 2; sgi++)
+            {
+              for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+                {
+                  WifiTxVector txVector (modes[m], 0, 0, sgi == 1, nss, 0, widths[w], false, false);
+                  for (double snr = 0.0; snr < 40.0; snr += 0.0371)
+                    {
+                      double linear = std::pow (10.0, snr / 10.0);
+                      double expected = yans->GetChunkSuccessRate (modes[m], txVector, linear, FrameSize * 8);
+                      double ps = table->GetChunkSuccessRate (modes[m], txVector, linear, FrameSize * 8);
+                      NS_TEST_ASSERT_MSG_EQ_TOL (ps, expected, 1e-4, "Not equal within tolerance for " << modes[m]
+                                                 << ", " << widths[w] << " MHz, " << +nss << " streams, sgi " << sgi
+                                                 << " at " << snr << " dB");
+                    }
+                }
+            }
+        }
+    }
+}
+
+class WifiErrorRateModelsTestCaseLinkAbstraction : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseLinkAbstraction ();
+  virtual ~WifiErrorRateModelsTestCaseLinkAbstraction ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseLinkAbstraction::WifiErrorRateModelsTestCaseLinkAbstraction ()
+  : TestCase ("WifiErrorRateModel test case HE link abstraction")
+{
+}
+
+WifiErrorRateModelsTestCaseLinkAbstraction::~WifiErrorRateModelsTestCaseLinkAbstraction ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseLinkAbstraction::DoRun (void)
+{
+  uint32_t FrameSize = 2000;
+  WifiTxVector txVector;
+  WifiMode mode ("OfdmRate24Mbps");
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+
+  // The default table gives the PER of the NIST model
+  Ptr<HELinkAbstraction> abstraction = CreateObject<HELinkAbstraction> ();
+  for (double snr = 0.0; snr < 30.0; snr += 0.0123)
+    {
+      double linear = std::pow (10.0, snr / 10.0);
+      double expected = 1 - nist->GetChunkSuccessRate (mode, txVector, linear, FrameSize * 8);
+      double per = abstraction->GetPer (mode, txVector, linear, FrameSize * 8);
+      NS_TEST_ASSERT_MSG_EQ_TOL (per, expected, 1e-4, "Not equal within tolerance at " << snr << " dB");
+    }
+
+  // Each link abstraction gets its own table, built with the defaults set
+  // after the HELinkAbstraction type was registered
+  Config::SetDefault ("ns3::TableErrorRateModel::SnrStep", DoubleValue (0.5));
+  Ptr<HELinkAbstraction> first = CreateObject<HELinkAbstraction> ();
+  Ptr<HELinkAbstraction> second = CreateObject<HELinkAbstraction> ();
+  first->GetPer (mode, txVector, 10.0, FrameSize * 8);
+  second->GetPer (mode, txVector, 10.0, FrameSize * 8);
+  Config::SetDefault ("ns3::TableErrorRateModel::SnrStep", DoubleValue (0.05));
+  PointerValue firstTable;
+  PointerValue secondTable;
+  first->GetAttribute ("ErrorRateModel", firstTable);
+  second->GetAttribute ("ErrorRateModel", secondTable);
+  NS_TEST_ASSERT_MSG_NE (firstTable.Get<TableErrorRateModel> (), 0, "No table created");
+  NS_TEST_ASSERT_MSG_NE (firstTable.Get<TableErrorRateModel> (), secondTable.Get<TableErrorRateModel> (), "Table shared");
+  DoubleValue step;
+  firstTable.Get<TableErrorRateModel> ()->GetAttribute ("SnrStep", step);
+  NS_TEST_EXPECT_MSG_EQ (step.Get (), 0.5, "Default SNR step not applied");
+
+  // An explicitly set model is queried directly
+  Ptr<HELinkAbstraction> direct = CreateObject<HELinkAbstraction> ();
+  direct->SetAttribute ("ErrorRateModel", PointerValue (nist));
+  double linear = std::pow (10.0, 7.77 / 10.0);
+  NS_TEST_EXPECT_MSG_EQ (direct->GetPer (mode, txVector, linear, FrameSize * 8),
+                         1 - nist->GetChunkSuccessRate (mode, txVector, linear, FrameSize * 8),
+                         "Explicit model not used");
+}
+
 class WifiErrorRateModelsTestSuite : public TestSuite
 {
 public:
@@ -290,6 +458,9 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTableYans, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseLinkAbstraction, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite;
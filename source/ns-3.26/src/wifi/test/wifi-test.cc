@@ -25,6 +25,7 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/adhoc-wifi-mac.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
@@ -39,6 +40,10 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/he-channel-leakage.h"
+#include "ns3/HE-wifi-channel.h"
+#include "ns3/uinteger.h"
+#include "ns3/constant-velocity-mobility-model.h"
 
 using namespace ns3;
 
@@ -213,6 +218,296 @@ public:
 };
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Check that an indexed WifiMacQueue returns the same packets as a
+ * scanned one.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Enqueue the same packet in both queues.
+   *
+   * \param addr1 the receiver address
+   * \param tid the TID, or -1 for a non-QoS frame
+   * \param front whether the packet is pushed at the front
+   */
+  void Enqueue (Mac48Address addr1, int tid, bool front);
+  /**
+   * Compare the queues after a lookup of each (address, TID) pair.
+   */
+  void Compare (void);
+
+  Ptr<WifiMacQueue> m_queues[2]; //!< scanned and indexed queues
+  Mac48Address m_addr[3];        //!< receiver addresses
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("WifiMacQueue with and without index")
+{
+}
+
+void
+WifiMacQueueIndexTest::Enqueue (Mac48Address addr1, int tid, bool front)
+{
+  WifiMacHeader hdr;
+  if (tid < 0)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (tid);
+    }
+  hdr.SetAddr1 (addr1);
+  Ptr<const Packet> packet = Create<Packet> (100 + tid);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      if (front)
+        {
+          m_queues[i]->PushFront (packet, hdr);
+        }
+      else
+        {
+          m_queues[i]->Enqueue (packet, hdr);
+        }
+    }
+}
+
+void
+WifiMacQueueIndexTest::Compare (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queues[1]->GetSize (), m_queues[0]->GetSize (), "Same number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queues[1]->GetBytes (), m_queues[0]->GetBytes (), "Same number of bytes");
+  for (uint32_t a = 0; a < 3; a++)
+    {
+      for (uint8_t tid = 0; tid < 2; tid++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_queues[1]->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, m_addr[a]),
+                                 m_queues[0]->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, m_addr[a]),
+                                 "Same number of packets for the address and TID");
+          WifiMacHeader hdr[2];
+          Time tstamp[2];
+          NS_TEST_EXPECT_MSG_EQ (m_queues[1]->PeekByTidAndAddress (&hdr[1], tid, WifiMacHeader::ADDR1, m_addr[a], &tstamp[1]),
+                                 m_queues[0]->PeekByTidAndAddress (&hdr[0], tid, WifiMacHeader::ADDR1, m_addr[a], &tstamp[0]),
+                                 "Same first packet for the address and TID");
+        }
+    }
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_queues[i] = CreateObject<WifiMacQueue> ();
+      m_queues[i]->SetMaxDelay (MilliSeconds (10));
+    }
+  m_queues[1]->SetIndexed (true);
+  m_addr[0] = Mac48Address ("00:00:00:00:00:01");
+  m_addr[1] = Mac48Address ("00:00:00:00:00:02");
+  m_addr[2] = Mac48Address ("00:00:00:00:00:03");
+
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i / 2), &WifiMacQueueIndexTest::Enqueue, this,
+                           m_addr[i % 3], (i % 7 == 6) ? -1 : int (i % 2), (i % 5 == 4));
+    }
+  //Lookups along the way, and after the first packets expired
+  for (uint32_t t = 3; t < 25; t += 4)
+    {
+      Simulator::Schedule (MilliSeconds (t), &WifiMacQueueIndexTest::Compare, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  //Drain one flow first, then the whole queue
+  WifiMacHeader hdr[2];
+  Ptr<const Packet> packet[2];
+  do
+    {
+      packet[0] = m_queues[0]->DequeueByTidAndAddress (&hdr[0], 1, WifiMacHeader::ADDR1, m_addr[1]);
+      packet[1] = m_queues[1]->DequeueByTidAndAddress (&hdr[1], 1, WifiMacHeader::ADDR1, m_addr[1]);
+      NS_TEST_EXPECT_MSG_EQ (packet[1], packet[0], "Same packet dequeued for the address and TID");
+    }
+  while (packet[0] != 0);
+  do
+    {
+      packet[0] = m_queues[0]->Dequeue (&hdr[0]);
+      packet[1] = m_queues[1]->Dequeue (&hdr[1]);
+      NS_TEST_EXPECT_MSG_EQ (packet[1], packet[0], "Same packet dequeued");
+    }
+  while (packet[0] != 0);
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the power leaked by HE transmissions into other channels.
+ */
+class HeChannelLeakageTest : public TestCase
+{
+public:
+  HeChannelLeakageTest () : TestCase ("HeChannelLeakage")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    HeChannelLeakage leakage;
+    //Channel 36 into the adjacent channel 40
+    double adjacent = leakage.GetLeakage (36, 20, 0xff, 40, 20);
+    NS_TEST_EXPECT_MSG_EQ_TOL (adjacent, HeChannelLeakage::CalculateLeakage (5180, 20, 20, 5200, 20), 1e-12,
+                               "Whole channel transmission centred on the channel");
+    NS_TEST_EXPECT_MSG_EQ_TOL (10 * std::log10 (adjacent), -21, 1, "Adjacent channel leakage");
+    NS_TEST_EXPECT_MSG_EQ (leakage.GetLeakage (36, 20, 0xff, 40, 20), adjacent, "Same value from the table");
+    NS_TEST_EXPECT_MSG_EQ (leakage.GetLeakage (36, 20, 0xff, 44, 20), 0, "No leakage beyond the mask");
+    NS_TEST_EXPECT_MSG_EQ_TOL (leakage.GetLeakage (40, 20, 0xff, 36, 20), adjacent, 1e-12, "Symmetric leakage");
+    //A 40 MHz receiver on channel 38 covers channel 36
+    NS_TEST_EXPECT_MSG_GT (leakage.GetLeakage (36, 20, 0xff, 38, 40), 0.99, "Overlapping channels");
+    //26-tone RUs: the one at the upper edge of channel 36 leaks more into channel 40 than the centre one
+    double centreRu = leakage.GetLeakage (36, 20, 8, 40, 20);
+    double edgeRu = leakage.GetLeakage (36, 20, 16, 40, 20);
+    NS_TEST_EXPECT_MSG_GT (edgeRu, centreRu, "Edge RU leaks more than the centre RU");
+    NS_TEST_EXPECT_MSG_GT (edgeRu, adjacent, "Edge RU leaks more than the whole channel");
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Deterministic loss model that counts how many received powers it computes.
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel () : m_calls (0)
+  {
+  }
+  uint32_t m_calls; //!< number of received powers computed
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    return txPowerDbm - 200 - a->GetDistanceFrom (b);
+  }
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                                int bitMap, int channelNumber)
+  {
+    m_calls++;
+    return txPowerDbm - 200 - a->GetDistanceFrom (b);
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+};
+
+/**
+ * Check that the path loss cache of HEWifiChannel follows the receivers
+ * that move without reporting a course change, and that its size is
+ * bounded.
+ */
+class HEWifiChannelPathLossCacheTest : public TestCase
+{
+public:
+  HEWifiChannelPathLossCacheTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param channel the channel
+   * \param mobility the mobility model of the PHY
+   * \return a PHY attached to the channel
+   */
+  Ptr<HEWifiPhy> CreatePhy (Ptr<HEWifiChannel> channel, Ptr<MobilityModel> mobility);
+  /**
+   * Send a frame from a PHY through its channel.
+   *
+   * \param channel the channel
+   * \param sender the transmitting PHY
+   */
+  void Send (Ptr<HEWifiChannel> channel, Ptr<HEWifiPhy> sender);
+  /**
+   * \param expected the expected number of computed received powers
+   * \param loss the loss model
+   */
+  void CheckCalls (uint32_t expected, Ptr<CountingPropagationLossModel> loss);
+};
+
+HEWifiChannelPathLossCacheTest::HEWifiChannelPathLossCacheTest ()
+  : TestCase ("HEWifiChannel path loss cache")
+{
+}
+
+Ptr<HEWifiPhy>
+HEWifiChannelPathLossCacheTest::CreatePhy (Ptr<HEWifiChannel> channel, Ptr<MobilityModel> mobility)
+{
+  Ptr<HEWifiPhy> phy = CreateObject<HEWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_2_4GHZ);
+  phy->SetChannel (channel);
+  return phy;
+}
+
+void
+HEWifiChannelPathLossCacheTest::Send (Ptr<HEWifiChannel> channel, Ptr<HEWifiPhy> sender)
+{
+  WifiTxVector txVector (WifiPhy::GetHeMcs0 (), 0, 0, false, 1, 0, 20, false, false);
+  channel->Send (sender, Create<Packet> (100), 16.0, txVector, WIFI_PREAMBLE_LONG, NORMAL_MPDU, MicroSeconds (100));
+}
+
+void
+HEWifiChannelPathLossCacheTest::CheckCalls (uint32_t expected, Ptr<CountingPropagationLossModel> loss)
+{
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls, expected, "Received powers computed at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+HEWifiChannelPathLossCacheTest::DoRun (void)
+{
+  Ptr<HEWifiChannel> channel = CreateObject<HEWifiChannel> ();
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetAttribute ("PathLossCache", BooleanValue (true));
+
+  Ptr<ConstantPositionMobilityModel> senderMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> staticMobility = CreateObject<ConstantPositionMobilityModel> ();
+  staticMobility->SetPosition (Vector (10.0, 0.0, 0.0));
+  //Constant velocity motion only reports a course change when the velocity is set
+  Ptr<ConstantVelocityMobilityModel> movingMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  movingMobility->SetPosition (Vector (0.0, 10.0, 0.0));
+  movingMobility->SetVelocity (Vector (0.0, 1.0, 0.0));
+  Ptr<HEWifiPhy> sender = CreatePhy (channel, senderMobility);
+  Ptr<HEWifiPhy> receiver = CreatePhy (channel, staticMobility);
+  CreatePhy (channel, movingMobility);
+
+  //Both receivers are computed once at the same time, then only the
+  //moving one is computed again
+  Simulator::Schedule (Seconds (1.0), &HEWifiChannelPathLossCacheTest::Send, this, channel, sender);
+  Simulator::Schedule (Seconds (1.0), &HEWifiChannelPathLossCacheTest::Send, this, channel, sender);
+  Simulator::Schedule (Seconds (1.1), &HEWifiChannelPathLossCacheTest::CheckCalls, this, 2, loss);
+  Simulator::Schedule (Seconds (2.0), &HEWifiChannelPathLossCacheTest::Send, this, channel, sender);
+  Simulator::Schedule (Seconds (2.1), &HEWifiChannelPathLossCacheTest::CheckCalls, this, 3, loss);
+  //A cache of one entry is emptied by every new entry, so the two links
+  //from the other transmitter keep evicting each other
+  Simulator::Schedule (Seconds (2.5), &HEWifiChannel::SetAttribute, channel, "PathLossCacheSize", UintegerValue (1));
+  Simulator::Schedule (Seconds (3.0), &HEWifiChannelPathLossCacheTest::Send, this, channel, receiver);
+  Simulator::Schedule (Seconds (3.0), &HEWifiChannelPathLossCacheTest::Send, this, channel, receiver);
+  Simulator::Schedule (Seconds (3.1), &HEWifiChannelPathLossCacheTest::CheckCalls, this, 7, loss);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+
 //-----------------------------------------------------------------------------
 /**
  * See \bugid{991}
@@ -1103,6 +1398,9 @@ WifiTestSuite::WifiTestSuite ()
 {
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
+  AddTestCase (new HeChannelLeakageTest, TestCase::QUICK);
+  AddTestCase (new HEWifiChannelPathLossCacheTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
@@ -0,0 +1,361 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2017 Cisco and/or its affiliates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Benchmark of the OFDMA code paths of the AP and STA MACs.
+ *
+ * Each scenario is a fixed topology of HE APs (RRMWifiManager) and STAs
+ * (ConstantRateWifiManager) exchanging uplink and downlink UDP traffic:
+ *
+ *   bss9, bss37, bss74: 1 AP with 9, 37 or 74 STAs
+ *   floor:              4 APs on a square, each with floorStas STAs
+ *
+ * The positions are deterministic and the random number generators are
+ * seeded with the seed and run arguments, so that two runs of the same
+ * build simulate the same events. Some MAC state (the AID counter of
+ * ApWifiMac) is global to the process, so the results of a scenario also
+ * depend on the scenarios run before it: keep the list of scenarios fixed
+ * when comparing two builds. Once the STAs have associated (after
+ * warmup seconds), the benchmark measures, until the end of the
+ * simulation:
+ *
+ *   - the wall clock time and the number of simulator events,
+ *   - the number of MSDUs passed up by the MACs (MacRx trace, at the APs
+ *     and the STAs) and of heap allocations,
+ *   - the calls to and the wall clock time spent in the WifiProfiler probes.
+ *
+ * One CSV line is printed per scenario, after a header line.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/wifi-profiler.h"
+
+using namespace ns3;
+
+// Number of calls to the global operator new since the start of the process
+static uint64_t g_nAllocs = 0;
+
+void *
+operator new (std::size_t size)
+{
+  g_nAllocs++;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return operator new (size);
+}
+
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+  std::free (p);
+}
+
+namespace ns3 {
+
+/**
+ * A map scheduler which counts the events removed from it, that is the
+ * events run (or cancelled) by the simulator.
+ */
+class CountingScheduler : public MapScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual Scheduler::Event RemoveNext (void);
+
+  static uint64_t m_nEvents; //!< number of events removed from all instances
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CountingScheduler);
+
+uint64_t CountingScheduler::m_nEvents = 0;
+
+TypeId
+CountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<CountingScheduler> ()
+  ;
+  return tid;
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext (void)
+{
+  m_nEvents++;
+  return MapScheduler::RemoveNext ();
+}
+
+} //namespace ns3
+
+// Counters of the measured window
+static uint64_t g_nMsdus = 0;
+static uint64_t g_eventsAtStart = 0;
+static uint64_t g_allocsAtStart = 0;
+static SystemWallClockMs g_clock;
+
+static void
+MacRx (Ptr<const Packet> packet)
+{
+  g_nMsdus++;
+}
+
+static void
+StartMeasurement (void)
+{
+  g_nMsdus = 0;
+  g_eventsAtStart = CountingScheduler::m_nEvents;
+  g_allocsAtStart = g_nAllocs;
+  WifiProfiler::Reset ();
+  WifiProfiler::Enable ();
+  g_clock.Start ();
+}
+
+struct Scenario
+{
+  std::string name;  //!< name of the scenario
+  uint32_t nAps;     //!< number of APs
+  uint32_t nStas;    //!< number of STAs per AP
+};
+
+static void
+PrintHeader (void)
+{
+  std::cout << "scenario,aps,stas,seed,run,sim_s,wall_s,events,events_per_sim_s,"
+            << "msdus,allocs,allocs_per_msdu";
+  for (uint32_t i = 0; i < WifiProfiler::N_PROBES; i++)
+    {
+      std::string name = WifiProfiler::GetName (static_cast<WifiProfiler::Probe> (i));
+      std::cout << "," << name << ".calls," << name << ".wall_s";
+    }
+  std::cout << std::endl;
+}
+
+static void
+RunScenario (const Scenario &scenario, uint32_t seed, uint32_t run,
+             double warmup, double duration, double interval, uint32_t packetSize)
+{
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+  GlobalValue::Bind ("SchedulerType", StringValue ("ns3::CountingScheduler"));
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_2_4GHZ);
+
+  HEWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::Enterprise11axPropagationLossModel");
+  HEWifiPhyHelper wifiPhy = HEWifiPhyHelper::Default ();
+  wifiPhy.SetErrorRateModel ("ns3::YansErrorRateModel");
+  wifiPhy.SetChannel (wifiChannel.Create ());
+
+  WifiMacHelper wifiMac;
+  NodeContainer nodes;
+  NetDeviceContainer devices;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  //APs on the corners of a 50 m square, STAs on rings around their AP
+  double apX[4] = {0, 50, 0, 50};
+  double apY[4] = {0, 0, 50, 50};
+  std::vector<uint32_t> apIndex;
+  for (uint32_t ap = 0; ap < scenario.nAps; ap++)
+    {
+      std::ostringstream ssid;
+      ssid << "bench-" << ap;
+      Ptr<Node> apNode = CreateObject<Node> ();
+      nodes.Add (apNode);
+      apIndex.push_back (devices.GetN ());
+      wifiMac.SetType ("ns3::ApWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())));
+      wifi.SetRemoteStationManager ("ns3::RRMWifiManager",
+                                    "DataMode", StringValue ("HeMcs0"),
+                                    "ControlMode", StringValue ("HeMcs0"),
+                                    "RateControl", UintegerValue (AARF));
+      devices.Add (wifi.Install (wifiPhy, wifiMac, apNode));
+      positionAlloc->Add (Vector (apX[ap], apY[ap], 3.0));
+
+      wifiMac.SetType ("ns3::StaWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())));
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue ("HeMcs0"),
+                                    "ControlMode", StringValue ("HeMcs0"));
+      for (uint32_t sta = 0; sta < scenario.nStas; sta++)
+        {
+          Ptr<Node> staNode = CreateObject<Node> ();
+          nodes.Add (staNode);
+          devices.Add (wifi.Install (wifiPhy, wifiMac, staNode));
+          double angle = 2 * M_PI * sta / scenario.nStas;
+          double radius = 2.0 + 3.0 * (sta % 3);
+          positionAlloc->Add (Vector (apX[ap] + radius * std::cos (angle),
+                                      apY[ap] + radius * std::sin (angle),
+                                      1.3));
+        }
+    }
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  //Uplink and downlink UDP flows between each STA and its AP
+  uint16_t port = 9;
+  UdpServerHelper server (port);
+  ApplicationContainer servers = server.Install (nodes);
+  servers.Start (Seconds (0));
+  ApplicationContainer clients;
+  for (uint32_t ap = 0; ap < scenario.nAps; ap++)
+    {
+      uint32_t a = apIndex[ap];
+      for (uint32_t s = a + 1; s <= a + scenario.nStas; s++)
+        {
+          UdpClientHelper uplink (interfaces.GetAddress (a), port);
+          uplink.SetAttribute ("MaxPackets", UintegerValue (0xffffffff));
+          uplink.SetAttribute ("Interval", TimeValue (Seconds (interval)));
+          uplink.SetAttribute ("PacketSize", UintegerValue (packetSize));
+          clients.Add (uplink.Install (nodes.Get (s)));
+
+          UdpClientHelper downlink (interfaces.GetAddress (s), port);
+          downlink.SetAttribute ("MaxPackets", UintegerValue (0xffffffff));
+          downlink.SetAttribute ("Interval", TimeValue (Seconds (interval)));
+          downlink.SetAttribute ("PacketSize", UintegerValue (packetSize));
+          clients.Add (downlink.Install (nodes.Get (a)));
+        }
+    }
+  clients.Start (Seconds (warmup));
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx",
+                                 MakeCallback (&MacRx));
+
+  Simulator::Schedule (Seconds (warmup), &StartMeasurement);
+  Simulator::Stop (Seconds (warmup + duration));
+  Simulator::Run ();
+  double wall = g_clock.End () / 1000.0;
+  WifiProfiler::Disable ();
+  uint64_t nEvents = CountingScheduler::m_nEvents - g_eventsAtStart;
+  uint64_t nAllocs = g_nAllocs - g_allocsAtStart;
+
+  std::cout << scenario.name << "," << scenario.nAps << "," << scenario.nAps * scenario.nStas
+            << "," << seed << "," << run << "," << duration << "," << wall
+            << "," << nEvents << "," << nEvents / duration
+            << "," << g_nMsdus << "," << nAllocs
+            << "," << (g_nMsdus > 0 ? static_cast<double> (nAllocs) / g_nMsdus : 0.0);
+  for (uint32_t i = 0; i < WifiProfiler::N_PROBES; i++)
+    {
+      WifiProfiler::Probe probe = static_cast<WifiProfiler::Probe> (i);
+      std::cout << "," << WifiProfiler::GetCalls (probe)
+                << "," << WifiProfiler::GetNanoSeconds (probe) * 1e-9;
+    }
+  std::cout << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  std::string scenarios ("bss9,bss37,bss74,floor");
+  uint32_t seed = 1;
+  uint32_t run = 1;
+  uint32_t floorStas = 9;
+  double warmup = 1.0;
+  double duration = 1.0;
+  double interval = 0.01;
+  uint32_t packetSize = 200;
+  bool header = true;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the OFDMA code paths of the wifi AP and STA MACs");
+  cmd.AddValue ("scenarios", "comma separated list of scenarios among bss9, bss37, bss74 and floor", scenarios);
+  cmd.AddValue ("seed", "seed of the random number generators", seed);
+  cmd.AddValue ("run", "run number of the random number generators", run);
+  cmd.AddValue ("floorStas", "number of STAs per AP of the floor scenario", floorStas);
+  cmd.AddValue ("warmup", "simulated time (s) before the measurement starts", warmup);
+  cmd.AddValue ("duration", "simulated time (s) of the measurement", duration);
+  cmd.AddValue ("interval", "interval (s) between two packets of a flow", interval);
+  cmd.AddValue ("packetSize", "size (bytes) of the UDP payloads", packetSize);
+  cmd.AddValue ("header", "print the CSV header line", header);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("2200"));
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("2200"));
+  Config::SetDefault ("ns3::WifiRemoteStationManager::NonUnicastMode", StringValue ("HeMcs0"));
+
+  if (header)
+    {
+      PrintHeader ();
+    }
+  std::istringstream list (scenarios);
+  std::string name;
+  while (std::getline (list, name, ','))
+    {
+      Scenario scenario;
+      scenario.name = name;
+      if (name == "bss9" || name == "bss37" || name == "bss74")
+        {
+          scenario.nAps = 1;
+          scenario.nStas = std::atoi (name.c_str () + 3);
+        }
+      else if (name == "floor")
+        {
+          scenario.nAps = 4;
+          scenario.nStas = floorStas;
+        }
+      else
+        {
+          std::cerr << "Unknown scenario " << name << std::endl;
+          return 1;
+        }
+      RunScenario (scenario, seed, run, warmup, duration, interval, packetSize);
+    }
+  return 0;
+}